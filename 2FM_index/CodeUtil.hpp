@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <array>
 #include <cstdint>
 #include <stdexcept>
@@ -24,6 +25,14 @@ inline uint8_t encode_base(char c) {
     }
 }
 
+// 리드 패턴의 'N' 코드: 레퍼런스 염기 코드(하위 2bit 01)와 어느 bit로든 달라 항상 mismatch
+constexpr uint8_t N_CODE = 0xF;
+
+// 리드 염기 -> 코드: 'N'은 N_CODE (kfmindex의 N 마스크, cfmindex의 PAD_CODE와 같이 어떤 염기와도 불일치)
+inline uint8_t encode_pattern_base(char c) {
+    return (c == 'N') ? N_CODE : encode_base(c);
+}
+
 // 코드 -> 염기
 inline char decode_base(uint8_t code) {
     switch (code & 0xF) {
@@ -48,7 +57,7 @@ inline int nibble_to_idx(uint8_t n) {
 }
 
 // 문자열 -> 팩킹: 홀수 길이면 마지막 염기 버리고 '$' 추가
-inline std::vector<uint8_t> pack_pairs(const std::string& seq) {
+inline std::vector<uint8_t> pack_pairs(std::string_view seq) {
     const std::size_t pair_cnt = seq.size() / 2;
     std::vector<uint8_t> res;
     res.reserve(pair_cnt + 1);
@@ -62,6 +71,38 @@ inline std::vector<uint8_t> pack_pairs(const std::string& seq) {
     return res;
 }
 
+// 리드 -> 쌍 코드 (out 재사용, '$' 없음, 홀수 길이면 마지막 염기 버림, 'N'은 N_CODE)
+inline void pack_pairs_into(std::string_view seq, std::vector<uint8_t>& out) {
+    const std::size_t pair_cnt = seq.size() / 2;
+    out.resize(pair_cnt);
+    for (std::size_t i = 0; i < pair_cnt; ++i) {
+        uint8_t high = encode_pattern_base(seq[2 * i]);
+        uint8_t low = encode_pattern_base(seq[2 * i + 1]);
+        out[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+}
+
+// 문자열 -> 4bit 팩킹 (홀수 길이면 마지막 하위 4bit는 0)
+inline std::vector<uint8_t> pack_nibbles(std::string_view seq) {
+    std::vector<uint8_t> res((seq.size() + 1) / 2, 0);
+    for (std::size_t i = 0; i < seq.size(); ++i) {
+        uint8_t c = encode_base(seq[i]);
+        res[i >> 1] |= static_cast<uint8_t>((i & 1) ? c : (c << 4));
+    }
+    return res;
+}
+
+// 패턴 쌍 코드에 'N' 염기가 있는지 (있으면 정확히 일치하는 쌍이 없음)
+inline bool has_n(uint8_t b) {
+    return (b >> 4) == N_CODE || (b & 0xF) == N_CODE;
+}
+
+// 두 쌍 코드에서 서로 다른 염기 수 (0~2, 패턴의 N_CODE 염기는 항상 다름)
+inline int pair_mismatch(uint8_t a, uint8_t b) {
+    uint8_t x = a ^ b;
+    return ((x & 0xF0) != 0) + ((x & 0x0F) != 0);
+}
+
 // 1바이트 코드 -> 알파벳 인덱스
 inline int byte_to_idx(uint8_t b) {
     if (b == SENT_PAIR) {
@@ -0,0 +1,108 @@
+#ifndef CONSENSUS_HPP
+#define CONSENSUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONSENSUS_SSE2 1
+#endif
+
+namespace consensus {
+
+// 투표 슬롯: 기존 256칸 max_element 동점 처리(작은 ASCII 우선)와 같은 순서
+constexpr int SLOTS = 5;
+constexpr char SLOT_BASE[SLOTS] = {'A', 'C', 'G', 'N', 'T'};
+constexpr uint16_t COUNT_MAX = 0xFFFF; // 포화 카운터 최댓값
+
+// 염기 -> 슬롯 (A,C,G,T 외에는 'N')
+inline int base_slot(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 4;
+        default:  return 3;
+    }
+}
+
+// 염기별 16bit 포화 카운터 (struct-of-arrays)
+class VoteTable {
+public:
+    explicit VoteTable(size_t ref_len) : len(ref_len) {
+        for (auto& c : counts) {
+            c.assign(ref_len, 0);
+        }
+    }
+
+    // 한 염기 투표
+    inline void add(size_t pos, char base) {
+        uint16_t& c = counts[base_slot(base)][pos];
+        if (c != COUNT_MAX) {
+            c++;
+        }
+    }
+
+    // 리드 전체를 pos부터 투표
+    template <typename Seq>
+    inline void add_read(size_t pos, const Seq& read) {
+        for (size_t j = 0; j < read.size(); j++) {
+            add(pos + j, read[j]);
+        }
+    }
+
+    // 위치별 최다 득표 염기 (득표 없으면 'N')
+    std::string call() const {
+        std::string out(len, 'N');
+        size_t i = 0;
+#ifdef CONSENSUS_SSE2
+        // 8칸씩: 부호 없는 비교를 위해 0x8000 xor 후 부호 있는 비교
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i none = _mm_set1_epi16('N');
+        for (; i + 8 <= len; i += 8) {
+            __m128i best = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts[0].data() + i));
+            __m128i sel  = _mm_set1_epi16(SLOT_BASE[0]);
+            for (int s = 1; s < SLOTS; s++) {
+                __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts[s].data() + i));
+                __m128i gt = _mm_cmpgt_epi16(_mm_xor_si128(v, bias), _mm_xor_si128(best, bias));
+                best = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, best));
+                sel  = _mm_or_si128(_mm_and_si128(gt, _mm_set1_epi16(SLOT_BASE[s])),
+                                    _mm_andnot_si128(gt, sel));
+            }
+            __m128i empty = _mm_cmpeq_epi16(best, zero);
+            sel = _mm_or_si128(_mm_and_si128(empty, none), _mm_andnot_si128(empty, sel));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[i]), _mm_packus_epi16(sel, sel));
+        }
+#endif
+        for (; i < len; i++) {
+            uint16_t best = counts[0][i];
+            int slot = 0;
+            for (int s = 1; s < SLOTS; s++) {
+                if (counts[s][i] > best) {
+                    best = counts[s][i];
+                    slot = s;
+                }
+            }
+            if (best > 0) {
+                out[i] = SLOT_BASE[slot];
+            }
+        }
+        return out;
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return SLOTS * len * sizeof(uint16_t);
+    }
+
+private:
+    size_t len;                                // 레퍼런스 길이
+    std::vector<uint16_t> counts[SLOTS];       // 슬롯별 득표 수
+};
+
+} // namespace consensus
+
+#endif // CONSENSUS_HPP
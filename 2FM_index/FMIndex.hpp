@@ -4,130 +4,331 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <array>
 #include <algorithm>
-#include <tuple>
-#include <stack>
-#include <numeric>
+#include <cstring>
+#include <stdexcept>
 #include "CodeUtil.hpp"
+#include "IOUtils.hpp"
+#include "Storage.hpp"
+#include "SuffixArray.hpp"
+#include "SampledSA.hpp"
+#include "OccTable.hpp"
 
 using namespace std;
 
 static constexpr uint8_t SENT_BYTE = code::SENT_PAIR; // 센티넬 바이트
 static const array<uint8_t, 16> ALPHABET = code::alphabet(); // 16쌍 알파벳 테이블
 
-class FMIndex {
-public:
+// 인덱스 파일 형식
+static constexpr char     INDEX_MAGIC[8] = "2FMIDX";
+static constexpr uint32_t INDEX_VERSION  = 4;
 
-    // 생성자: FM-Index 구축
-    FMIndex(const string& reference) {
+// 인덱스 파일 헤더
+struct IndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t word_size;     // sizeof(size_t)
+    uint64_t ref_checksum;  // 레퍼런스 FNV-1a 체크섬
+    uint64_t length;        // 레퍼런스 길이 (염기 단위)
+};
 
-        // 염기 -> 1바이트로 팩킹 + 끝에 '$' 추가
-        auto packed_text = code::pack_pairs(reference);
+// 검색 스택 항목
+struct SearchFrame {
+    int    idx;    // 다음에 맞출 패턴 위치 (바이트 쌍 단위)
+    size_t left;   // SA 구간 시작
+    size_t right;  // SA 구간 끝
+    int    errs;   // 남은 mismatch 허용 수
+};
 
+// 검색 작업 공간: 스레드마다 하나씩 두고 재사용하면 검색 중 할당 없음
+struct SearchContext {
+    vector<SearchFrame> stack;   // DFS 스택
+    vector<uint8_t>     pattern; // 쌍 코드 패턴
+    vector<size_t>      hits;    // 결과 위치
+};
+
+// 한 위상(phase)의 쌍 FM-index: 레퍼런스를 phase 염기만큼 민 뒤 두 염기씩 팩킹
+class PairFrame {
+public:
+    PairFrame() = default;
+
+    // 쌍 텍스트('$' 포함)로 구축
+    void build(const vector<uint8_t>& packed_text, size_t sa_rate) {
         length = packed_text.size(); // 바이트 단위
         build_sa(packed_text);
-        build_bwt(packed_text);
-        build_c();
-        build_occ();
+        build_occ(packed_text);
+        build_ssa(sa_rate);
     }
 
-    // 패턴 검색: max_err 만큼 mismatch 허용
-    vector<size_t> locate(const string& pattern, int max_err) const {
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(length));
+        w.put(C);
+        occ.save(w);
+        ssa.save(w);
+    }
 
-        // 패턴 팩킹
-        auto pbytes = code::pack_pairs(pattern);
-        pbytes.pop_back(); // 팩커가 붙인 '$' 제거
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        length = static_cast<size_t>(r.get<uint64_t>());
+        C = r.get<array<uint64_t, 17>>();
+        occ.load(r);
+        ssa.load(r);
+    }
 
-        vector<size_t> result;
-        stack<tuple<int, size_t, size_t, int>> stk;
-        stk.emplace(static_cast<int>(pbytes.size()) - 1, 0, length, max_err);
+    // 쌍 k를 앞에 붙인 구간 [left, right) -> 새 구간
+    inline size_t extend(int k, size_t i) const {
+        return C[k] + occ.rank(k, i);
+    }
 
-        while (!stk.empty()) {
-            int idx;
-            size_t left, right;
-            int errs;
-            tie(idx, left, right, errs) = stk.top();
-            stk.pop();
+    // 17개 심볼 모두를 앞에 붙였을 때 구간 경계 i의 새 위치 (블록 한 번 접근)
+    inline void extend_all(size_t i, size_t out[17]) const {
+        occ.rank_all(i, out);
+        for (size_t k = 0; k < 17; k++) {
+            out[k] += C[k];
+        }
+    }
 
-            if (errs < 0 || left >= right) {
-                continue;
-            }
+    // SA 값 조회: 샘플이 아니면 LF로 거슬러 올라감
+    inline size_t sa_value(size_t row) const {
+        return ssa.lookup(row, [this](size_t r) { return lf(r); });
+    }
 
-            // 패턴 끝 도달시 SA 구간의 위치 추가
-            if (idx < 0) {
-                for (size_t i = left; i < right; i++) {
-                    result.push_back(sa[i] * 2); // 바이트 -> 염기 좌표
-                }
-                continue;
-            }
+    size_t rows() const {
+        return length;
+    }
 
-            uint8_t target = pbytes[idx];
-            for (uint8_t byte : ALPHABET) {
-                int k  = code::byte_to_idx(byte);
-                size_t nl = C[k] + (left  ? occ[left  - 1][k] : 0);
-                size_t nr = C[k] +          occ[right - 1][k];
-                if (nl >= nr) continue;
-                stk.emplace(idx - 1, nl, nr, errs - (byte != target));
-            }
-        }
+    size_t sa_rate() const {
+        return ssa.rate();
+    }
 
-        sort(result.begin(), result.end());
-        result.erase(unique(result.begin(), result.end()), result.end());
-        return result;
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return ssa.bytes() + occ.bytes() + sizeof(C);
+    }
+
+    // OCC 테이블 메모리 (바이트, BWT 심볼 포함)
+    size_t occ_bytes() const {
+        return occ.bytes();
     }
 
 private:
-    size_t length;                    // 레퍼런스 길이
-    vector<size_t> sa;                // 접두사 배열
-    vector<uint8_t> bwt;              // BWT 배열
-    array<uint32_t, 17> C;            // 누적 빈도 배열
-    vector<array<uint32_t, 17>> occ;  // OCC 테이블
+    size_t length = 0;                     // 쌍 텍스트 길이
+    vector<size_t> sa;                     // 접두사 배열 (구축 중에만 사용)
+    suffix::SampledSA ssa;                 // 샘플링 SA
+    array<uint64_t, 17> C;                 // 누적 빈도 배열 (64bit: 2^32 행 이상)
+    occ::OccTable occ;                     // BWT + 블록 랭크 사전
 
-    // SA 구축
+    // SA 구축: SA-IS (바이트 쌍 알파벳 256)
     void build_sa(const vector<uint8_t>& text) {
-        sa.resize(length);
-        iota(sa.begin(), sa.end(), static_cast<size_t>(0));
-        sort(sa.begin(), sa.end(),
-            [&](size_t a, size_t b) {
-                return lexicographical_compare(
-                    text.begin() + a, text.end(),
-                    text.begin() + b, text.end()
-                );
-            });
-    }
-
-    // BWT 구축
-    void build_bwt(const vector<uint8_t>& text) {
-        bwt.resize(length);
+        sa = suffix::sais(text, 256);
+    }
+
+    // BWT(알파벳 인덱스) -> C, OCC 구축
+    void build_occ(const vector<uint8_t>& text) {
+        vector<uint8_t> bwt(length);
         for (size_t i = 0; i < length; i++) {
             size_t pos = (sa[i] == 0) ? (length - 1) : (sa[i] - 1);
-            bwt[i] = text[pos];
+            bwt[i] = static_cast<uint8_t>(code::byte_to_idx(text[pos]));
         }
-    }
 
-    // C 구축
-    void build_c() {
         C.fill(0);
-        for (uint8_t byte : bwt) {
-            C[code::byte_to_idx(byte)]++;
+        for (uint8_t k : bwt) {
+            C[k]++;
         }
-        uint32_t sum = 0;
+        uint64_t sum = 0;
         for (size_t k = 0; k < C.size(); k++) {
-            uint32_t cnt = C[k];
+            uint64_t cnt = C[k];
             C[k] = sum;
             sum += cnt;
         }
+
+        occ.build(bwt);
     }
 
-    // OCC 테이블 구축
-    void build_occ() {
-        occ.assign(length, array<uint32_t,17>{});
-        array<uint32_t,17> acc{};
-        for (size_t i = 0; i < length; i++) {
-            acc[code::byte_to_idx(bwt[i])]++;
-            occ[i] = acc;
+    // 샘플링 SA 구축: 전체 SA는 넘겨주고 해제
+    void build_ssa(size_t sa_rate) {
+        ssa.build(std::move(sa), sa_rate);
+        vector<size_t>().swap(sa);
+    }
+
+    // LF 매핑
+    inline size_t lf(size_t row) const {
+        return extend(occ.symbol(row), row);
+    }
+};
+
+class FMIndex {
+public:
+
+    // 생성자: 짝수/홀수 시작 위치용 두 위상의 FM-Index 구축, sa_rate 간격으로 SA 샘플링
+    FMIndex(const string& reference, size_t sa_rate = 1) {
+        ref_len = reference.size();
+        for (size_t phase = 0; phase < 2; phase++) {
+            // 염기 -> 1바이트로 팩킹 + 끝에 '$' 추가 (홀수 길이면 마지막 염기는 다른 위상이 담당)
+            string_view shifted(reference);
+            shifted.remove_prefix(min(phase, shifted.size()));
+            frames[phase].build(code::pack_pairs(shifted), sa_rate);
+        }
+        ref_nibbles = code::pack_nibbles(reference);
+    }
+
+    // 패턴 검색: max_err 만큼 mismatch 허용
+    vector<size_t> locate(string_view pattern, int max_err) const {
+        SearchContext ctx;
+        locate(pattern, max_err, ctx);
+        return std::move(ctx.hits);
+    }
+
+    // 패턴 검색 (작업 공간 재사용): 결과는 ctx.hits, 정렬 및 중복 제거됨
+    // 두 위상에서 쌍 단위로 검색하고, 홀수 길이 리드의 마지막 염기는 레퍼런스와 직접 비교
+    const vector<size_t>& locate(string_view pattern, int max_err, SearchContext& ctx) const {
+        code::pack_pairs_into(pattern, ctx.pattern);
+        ctx.hits.clear();
+        for (size_t phase = 0; phase < 2; phase++) {
+            search_frame(phase, pattern, max_err, ctx);
+        }
+
+        auto& result = ctx.hits;
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // 인덱스 전체 메모리 (바이트)
+    size_t memory_bytes() const {
+        return frames[0].bytes() + frames[1].bytes() + ref_nibbles.bytes();
+    }
+
+    // SA 샘플링 간격
+    size_t sa_rate() const {
+        return frames[0].sa_rate();
+    }
+
+    // 두 위상의 OCC 테이블 메모리 (바이트)
+    size_t occ_bytes() const {
+        return frames[0].occ_bytes() + frames[1].occ_bytes();
+    }
+
+    // 두 위상의 BWT 행 수
+    size_t rows() const {
+        return frames[0].rows() + frames[1].rows();
+    }
+
+    // 인덱스 파일 저장
+    void save(const string& path, uint64_t ref_checksum) const {
+        store::Writer w(path);
+        IndexHeader hdr{};
+        memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+        hdr.version      = INDEX_VERSION;
+        hdr.word_size    = sizeof(size_t);
+        hdr.ref_checksum = ref_checksum;
+        hdr.length       = ref_len;
+        w.put(hdr);
+        frames[0].save(w);
+        frames[1].save(w);
+        w.put_array(ref_nibbles);
+        w.finish();
+    }
+
+    // 인덱스 파일을 읽기 전용으로 매핑하여 로드
+    static FMIndex load(const string& path, uint64_t ref_checksum) {
+        FMIndex fm;
+        fm.file = io::MappedFile(path);
+        store::Reader r(fm.file.data(), fm.file.size());
+
+        auto hdr = r.get<IndexHeader>();
+        if (memcmp(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic)) != 0) {
+            throw runtime_error("not a 2FM index file: " + path);
+        }
+        if (hdr.version != INDEX_VERSION || hdr.word_size != sizeof(size_t)) {
+            throw runtime_error("unsupported index version: " + path);
+        }
+        if (hdr.ref_checksum != ref_checksum) {
+            throw runtime_error("index does not match reference: " + path);
+        }
+
+        fm.ref_len = static_cast<size_t>(hdr.length);
+        fm.frames[0].load(r);
+        fm.frames[1].load(r);
+        r.get_array(fm.ref_nibbles);
+        return fm;
+    }
+
+private:
+    FMIndex() = default;
+
+    io::MappedFile file;                 // 로드 시 매핑된 인덱스 파일
+    size_t ref_len = 0;                  // 레퍼런스 길이 (염기 단위)
+    array<PairFrame, 2> frames;          // 위상 0: ref[0..], 위상 1: ref[1..]
+    store::Array<uint8_t> ref_nibbles;   // 4bit 팩킹 레퍼런스 (마지막 염기 확인용)
+
+    // 레퍼런스 pos 위치 염기 코드
+    inline uint8_t ref_code(size_t pos) const {
+        uint8_t byte = ref_nibbles[pos >> 1];
+        return (pos & 1) ? (byte & 0x0F) : (byte >> 4);
+    }
+
+    // 한 위상에서 쌍 패턴 검색, 결과는 염기 좌표로 ctx.hits에 추가
+    void search_frame(size_t phase, string_view read, int max_err, SearchContext& ctx) const {
+        const PairFrame& fr = frames[phase];
+        const auto& pbytes = ctx.pattern;
+        auto& stk = ctx.stack;
+        auto& result = ctx.hits;
+        size_t read_len = read.size();
+        bool   odd = (read_len & 1) != 0;
+        uint8_t last = odd ? code::encode_pattern_base(read.back()) : 0; // 'N'이면 어떤 염기와도 다름
+
+        stk.clear();
+        stk.push_back({static_cast<int>(pbytes.size()) - 1, 0, fr.rows(), max_err});
+
+        while (!stk.empty()) {
+            SearchFrame cur = stk.back();
+            stk.pop_back();
+
+            if (cur.errs < 0 || cur.left >= cur.right) {
+                continue;
+            }
+
+            // 패턴 끝 도달시 SA 구간의 위치 추가
+            if (cur.idx < 0) {
+                for (size_t i = cur.left; i < cur.right; i++) {
+                    size_t pos = fr.sa_value(i) * 2 + phase; // 바이트 -> 염기 좌표
+                    if (pos + read_len > ref_len) {
+                        continue;
+                    }
+                    // 홀수 길이 리드의 마지막 염기는 남은 허용 수로 확인
+                    if (odd && ref_code(pos + read_len - 1) != last && cur.errs == 0) {
+                        continue;
+                    }
+                    result.push_back(pos);
+                }
+                continue;
+            }
+
+            // 허용 mismatch가 남지 않았으면 패턴 쌍 하나만 확장 가능 (N이 있으면 일치하는 쌍 없음)
+            uint8_t target = pbytes[cur.idx];
+            if (cur.errs == 0) {
+                if (code::has_n(target)) {
+                    continue;
+                }
+                int k = code::byte_to_idx(target);
+                stk.push_back({cur.idx - 1, fr.extend(k, cur.left), fr.extend(k, cur.right), 0});
+                continue;
+            }
+
+            // 16쌍 확장: 구간 양 끝의 랭크를 블록당 한 번에 계산
+            size_t lo[17], hi[17];
+            fr.extend_all(cur.left, lo);
+            fr.extend_all(cur.right, hi);
+            for (uint8_t byte : ALPHABET) {
+                int k = code::byte_to_idx(byte);
+                if (lo[k] >= hi[k]) continue;
+                stk.push_back({cur.idx - 1, lo[k], hi[k], cur.errs - code::pair_mismatch(byte, target)});
+            }
         }
     }
 };
@@ -0,0 +1,130 @@
+#ifndef OCCTABLE_HPP
+#define OCCTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Storage.hpp"
+
+namespace occ {
+
+constexpr size_t PAIR_SYMBOLS = 16;     // '$'를 뺀 쌍 심볼 수
+constexpr size_t BLOCK_ROWS   = 32;     // 블록당 BWT 행 수
+constexpr size_t SUPER_ROWS   = 65536;  // 상위 블록당 행 수 (16bit 블록 누적 수 한계)
+
+// 캐시 라인 블록: 상위 블록 시작부터 이 블록 시작까지의 쌍 1~16 누적 수 + BWT 심볼 인덱스
+struct alignas(64) Block {
+    uint16_t counts[PAIR_SYMBOLS];
+    uint8_t  syms[BLOCK_ROWS];
+};
+static_assert(sizeof(Block) == 64, "Block must fill one cache line");
+
+// 17심볼 블록 랭크 사전: 심볼 인덱스 0 = '$', 1~16 = 사전식 쌍
+// 65536행마다 64bit 누적 수, 블록마다 16bit 상대 누적 수를 두어 랭크 한 번에 캐시 라인 하나만 읽음
+class OccTable {
+public:
+    OccTable() = default;
+
+    // 심볼 인덱스 BWT로부터 구축
+    void build(const std::vector<uint8_t>& bwt_idx) {
+        size_t length = bwt_idx.size();
+        sent_pos = length;
+        std::vector<uint64_t> supers((length / SUPER_ROWS + 1) * PAIR_SYMBOLS, 0);
+        std::vector<Block>    blocks(length / BLOCK_ROWS + 1, Block{});
+
+        uint64_t acc[PAIR_SYMBOLS] = {};
+        uint64_t base[PAIR_SYMBOLS] = {};
+        for (size_t i = 0; i <= length; i++) {
+            if (i % SUPER_ROWS == 0) {
+                for (size_t c = 0; c < PAIR_SYMBOLS; c++) {
+                    supers[(i / SUPER_ROWS) * PAIR_SYMBOLS + c] = acc[c];
+                    base[c] = acc[c];
+                }
+            }
+            if (i % BLOCK_ROWS == 0) {
+                for (size_t c = 0; c < PAIR_SYMBOLS; c++) {
+                    blocks[i / BLOCK_ROWS].counts[c] = static_cast<uint16_t>(acc[c] - base[c]);
+                }
+            }
+            if (i == length) {
+                break;
+            }
+            uint8_t k = bwt_idx[i];
+            blocks[i / BLOCK_ROWS].syms[i % BLOCK_ROWS] = k;
+            if (k == 0) {
+                sent_pos = i; // 센티넬은 위치만 기록
+                continue;
+            }
+            acc[k - 1]++;
+        }
+        this->supers = std::move(supers);
+        this->blocks = std::move(blocks);
+    }
+
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(sent_pos));
+        w.put_array(supers);
+        w.put_array(blocks);
+    }
+
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        sent_pos = static_cast<size_t>(r.get<uint64_t>());
+        r.get_array(supers);
+        r.get_array(blocks);
+    }
+
+    // bwt[0, i) 구간의 심볼 k 개수
+    inline size_t rank(int k, size_t i) const {
+        if (k == 0) {
+            return (i > sent_pos) ? 1 : 0;
+        }
+        const Block& blk = blocks[i / BLOCK_ROWS];
+        size_t c = static_cast<size_t>(k - 1);
+        size_t cnt = supers[(i / SUPER_ROWS) * PAIR_SYMBOLS + c] + blk.counts[c];
+
+        // 고정 길이 루프로 두어 컴파일러가 벡터화할 수 있게 함
+        unsigned r = static_cast<unsigned>(i % BLOCK_ROWS);
+        unsigned hit = 0;
+        for (unsigned j = 0; j < BLOCK_ROWS; j++) {
+            hit += (blk.syms[j] == k) & (j < r);
+        }
+        return cnt + hit;
+    }
+
+    // bwt[0, i) 구간의 모든 심볼 개수를 한 블록 접근으로 계산
+    inline void rank_all(size_t i, size_t out[PAIR_SYMBOLS + 1]) const {
+        const Block& blk = blocks[i / BLOCK_ROWS];
+        const uint64_t* sup = &supers[(i / SUPER_ROWS) * PAIR_SYMBOLS];
+        size_t r = i % BLOCK_ROWS;
+
+        unsigned hist[PAIR_SYMBOLS + 1] = {};
+        for (size_t j = 0; j < r; j++) {
+            hist[blk.syms[j]]++;
+        }
+        out[0] = (i > sent_pos) ? 1 : 0;
+        for (size_t c = 0; c < PAIR_SYMBOLS; c++) {
+            out[c + 1] = sup[c] + blk.counts[c] + hist[c + 1];
+        }
+    }
+
+    // bwt[i]의 심볼 인덱스
+    inline int symbol(size_t i) const {
+        return blocks[i / BLOCK_ROWS].syms[i % BLOCK_ROWS];
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return supers.bytes() + blocks.bytes();
+    }
+
+private:
+    size_t sent_pos = 0;            // BWT 내 센티넬 위치
+    store::Array<uint64_t> supers;  // (행 수 / 65536 + 1) x 16 누적 수
+    store::Array<Block>    blocks;  // 캐시 라인 블록
+};
+
+} // namespace occ
+
+#endif // OCCTABLE_HPP
@@ -0,0 +1,95 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "Parallel.hpp"
+
+using namespace std;
+
+namespace opt {
+
+// 실행 옵션 (2fmindex: cfmindex 전용 검색 옵션은 받지 않음)
+struct Options {
+    size_t sa_rate = 1;   // SA 샘플링 간격 (--sa-rate)
+    string index_path;    // 저장된 인덱스 파일 (--index)
+    size_t threads = par::default_threads(); // 매핑 스레드 수 (--threads)
+    bool scaling = false; // 1, 2, 4, ... 스레드 매핑 시간 측정 (--scaling)
+    size_t batch = 4096;  // 파이프라인 배치당 리드 수 (--batch)
+    vector<string> given; // 명령행에 준 옵션 이름
+};
+
+// 정수 옵션 값 파싱
+inline size_t parse_size(const string& name, const string& value) {
+    size_t used = 0;
+    unsigned long long v = 0;
+    try {
+        v = stoull(value, &used);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != value.size() || value.empty() || value[0] == '-') {
+        throw invalid_argument("invalid value for " + name + ": " + value);
+    }
+    return static_cast<size_t>(v);
+}
+
+// 명령행 옵션 파싱
+inline Options parse_options(int argc, char* argv[]) {
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) {
+                throw invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--sa-rate") {
+            opts.sa_rate = parse_size(arg, value());
+            if (opts.sa_rate == 0) {
+                throw invalid_argument("--sa-rate must be positive");
+            }
+        } else if (arg == "--threads") {
+            opts.threads = parse_size(arg, value());
+            if (opts.threads == 0) {
+                throw invalid_argument("--threads must be positive");
+            }
+        } else if (arg == "--batch") {
+            opts.batch = parse_size(arg, value());
+            if (opts.batch == 0) {
+                throw invalid_argument("--batch must be positive");
+            }
+        } else if (arg == "--scaling") {
+            opts.scaling = true;
+        } else if (arg == "--index") {
+            opts.index_path = value();
+        } else {
+            throw invalid_argument("unknown option for 2fmindex: " + arg);
+        }
+        opts.given.push_back(arg);
+    }
+    return opts;
+}
+
+// 옵션을 명령행에서 주었는지
+inline bool given(const Options& opts, const string& name) {
+    return find(opts.given.begin(), opts.given.end(), name) != opts.given.end();
+}
+
+// used에 없는 옵션을 주었으면 거부: 이 실행 파일에서 효과가 없는 옵션을 조용히 무시하지 않음
+inline void reject_unused(const Options& opts, const vector<string>& used, const string& tool) {
+    for (const auto& name : opts.given) {
+        if (find(used.begin(), used.end(), name) == used.end()) {
+            throw invalid_argument(name + " has no effect on " + tool);
+        }
+    }
+}
+
+} // namespace opt
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,166 @@
+#ifndef SUFFIXARRAY_HPP
+#define SUFFIXARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+namespace suffix {
+
+// 빈 슬롯 표시
+constexpr size_t EMPTY = static_cast<size_t>(-1);
+
+// SA-IS 본체: s[n-1]은 유일한 최소 문자(센티넬), 알파벳 크기 K
+template <typename T>
+void sais_core(const T* s, size_t* sa, size_t n, size_t K) {
+    if (n == 1) {
+        sa[0] = 0;
+        return;
+    }
+
+    // 접미사 타입 분류 (true = S, false = L)
+    std::vector<bool> t(n);
+    t[n - 1] = true;
+    for (size_t i = n - 1; i-- > 0;) {
+        t[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && t[i + 1]);
+    }
+    auto is_lms = [&](size_t i) { return i > 0 && t[i] && !t[i - 1]; };
+
+    // 버킷 경계 계산
+    std::vector<size_t> bkt(K);
+    auto get_buckets = [&](bool end) {
+        std::fill(bkt.begin(), bkt.end(), 0);
+        for (size_t i = 0; i < n; i++) {
+            bkt[static_cast<size_t>(s[i])]++;
+        }
+        size_t sum = 0;
+        for (size_t c = 0; c < K; c++) {
+            sum += bkt[c];
+            bkt[c] = end ? sum : sum - bkt[c];
+        }
+    };
+
+    // L형, S형 유도 정렬
+    auto induce = [&]() {
+        get_buckets(false);
+        for (size_t i = 0; i < n; i++) {
+            size_t j = sa[i];
+            if (j != EMPTY && j > 0 && !t[j - 1]) {
+                sa[bkt[static_cast<size_t>(s[j - 1])]++] = j - 1;
+            }
+        }
+        get_buckets(true);
+        for (size_t i = n; i-- > 0;) {
+            size_t j = sa[i];
+            if (j != EMPTY && j > 0 && t[j - 1]) {
+                sa[--bkt[static_cast<size_t>(s[j - 1])]] = j - 1;
+            }
+        }
+    };
+
+    // 1단계: LMS 부분문자열 정렬
+    get_buckets(true);
+    std::fill(sa, sa + n, EMPTY);
+    for (size_t i = 1; i < n; i++) {
+        if (is_lms(i)) {
+            sa[--bkt[static_cast<size_t>(s[i])]] = i;
+        }
+    }
+    induce();
+
+    // 정렬된 LMS를 앞쪽으로 모음
+    size_t n1 = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (is_lms(sa[i])) {
+            sa[n1++] = sa[i];
+        }
+    }
+
+    // LMS 부분문자열 이름 부여
+    std::fill(sa + n1, sa + n, EMPTY);
+    size_t name = 0;
+    size_t prev = EMPTY;
+    for (size_t i = 0; i < n1; i++) {
+        size_t pos  = sa[i];
+        bool   diff = false;
+        for (size_t d = 0; d < n; d++) {
+            if (prev == EMPTY || s[pos + d] != s[prev + d] || t[pos + d] != t[prev + d]) {
+                diff = true;
+                break;
+            }
+            if (d > 0 && (is_lms(pos + d) || is_lms(prev + d))) {
+                break;
+            }
+        }
+        if (diff) {
+            name++;
+            prev = pos;
+        }
+        sa[n1 + pos / 2] = name - 1;
+    }
+
+    // 축약 문자열 (텍스트 순서)
+    std::vector<size_t> s1;
+    s1.reserve(n1);
+    for (size_t i = n1; i < n; i++) {
+        if (sa[i] != EMPTY) {
+            s1.push_back(sa[i]);
+        }
+    }
+
+    // 2단계: 축약 문자열의 SA (이름이 겹치면 재귀)
+    std::vector<size_t> sa1(n1);
+    if (name < n1) {
+        sais_core(s1.data(), sa1.data(), n1, name);
+    } else {
+        for (size_t i = 0; i < n1; i++) {
+            sa1[s1[i]] = i;
+        }
+    }
+
+    // 3단계: LMS 순서 확정 후 전체 유도
+    size_t j = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (is_lms(i)) {
+            s1[j++] = i;
+        }
+    }
+    get_buckets(true);
+    std::fill(sa, sa + n, EMPTY);
+    for (size_t i = n1; i-- > 0;) {
+        size_t p = s1[sa1[i]];
+        sa[--bkt[static_cast<size_t>(s[p])]] = p;
+    }
+    induce();
+}
+
+// 선형 시간 SA 구축: text 끝은 유일한 최소 문자여야 함
+template <typename T>
+std::vector<size_t> sais(const std::vector<T>& text, size_t alphabet_size) {
+    std::vector<size_t> sa(text.size());
+    if (!text.empty()) {
+        sais_core(text.data(), sa.data(), text.size(), alphabet_size);
+    }
+    return sa;
+}
+
+// 비교 정렬 기반 SA 구축 (기존 방식, 벤치마크 비교용)
+template <typename T>
+std::vector<size_t> sort_suffixes(const std::vector<T>& text) {
+    std::vector<size_t> sa(text.size());
+    std::iota(sa.begin(), sa.end(), static_cast<size_t>(0));
+    std::sort(sa.begin(), sa.end(),
+        [&](size_t a, size_t b) {
+            return std::lexicographical_compare(
+                text.begin() + a, text.end(),
+                text.begin() + b, text.end()
+            );
+        });
+    return sa;
+}
+
+} // namespace suffix
+
+#endif // SUFFIXARRAY_HPP
@@ -0,0 +1,188 @@
+#ifndef ALIGN_HPP
+#define ALIGN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace align {
+
+// CIGAR 연산: (길이 << 2) | 연산
+// M = 일치 또는 치환, I = 리드에만 있는 염기 (삽입), D = 레퍼런스에만 있는 염기 (삭제)
+enum Op : uint32_t { OP_M = 0, OP_I = 1, OP_D = 2 };
+
+inline uint32_t op_code(uint32_t c) { return c & 0x3; }
+inline uint32_t op_len(uint32_t c)  { return c >> 2; }
+
+// CIGAR가 덮는 레퍼런스 길이
+inline size_t ref_span(const uint32_t* ops, size_t n) {
+    size_t span = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (op_code(ops[k]) != OP_I) {
+            span += op_len(ops[k]);
+        }
+    }
+    return span;
+}
+
+// 염기 -> 2bit 값 (A,C,G,T 외에는 -1: 어떤 염기와도 불일치)
+inline int base_idx(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default:  return -1;
+    }
+}
+
+// 편집 거리 정렬기: 작업 공간을 재사용하므로 스레드마다 하나씩 사용
+class Aligner {
+public:
+    // 리드 전체를 ref[lo, hi) 안의 구간에 맞추는 (시작/끝 자유) 최소 편집 거리와 끝 위치
+    // Myers 비트 병렬 알고리즘: 64bit 워드 하나로 DP 열의 64칸을 한 번에 갱신
+    // max_err 이하가 없으면 false, 같은 거리면 expect_end에 가까운 끝 위치 선택
+    bool best_end(std::string_view read, std::string_view ref, size_t lo, size_t hi,
+                  size_t expect_end, int max_err, size_t& end, int& dist) {
+        size_t m = read.size();
+        size_t nb = (m + 63) / 64;
+        if (m == 0 || lo >= hi) {
+            return false;
+        }
+        peq.assign(4 * nb, 0);
+        for (size_t i = 0; i < m; i++) {
+            int c = base_idx(read[i]);
+            if (c >= 0) {
+                peq[c * nb + i / 64] |= 1ULL << (i % 64);
+            }
+        }
+        pv.assign(nb, ~0ULL);
+        mv.assign(nb, 0);
+        const uint64_t last = 1ULL << ((m - 1) % 64); // 마지막 블록의 리드 끝 행
+        const uint64_t high = 1ULL << 63;
+
+        int score = static_cast<int>(m); // D[m][lo - 1]
+        bool found = false;
+        for (size_t j = lo; j < hi; j++) {
+            int c = base_idx(ref[j]);
+            int hin = 0; // 검색 모드: 맨 윗줄은 모두 0
+            for (size_t b = 0; b < nb; b++) {
+                uint64_t eq = c >= 0 ? peq[c * nb + b] : 0;
+                uint64_t Pv = pv[b], Mv = mv[b];
+                uint64_t Xv = eq | Mv;
+                if (hin < 0) {
+                    eq |= 1;
+                }
+                uint64_t Xh = (((eq & Pv) + Pv) ^ Pv) | eq;
+                uint64_t Ph = Mv | ~(Xh | Pv);
+                uint64_t Mh = Pv & Xh;
+                uint64_t top = (b + 1 == nb) ? last : high;
+                int hout = (Ph & top) ? 1 : (Mh & top) ? -1 : 0;
+                Ph <<= 1;
+                Mh <<= 1;
+                if (hin < 0) {
+                    Mh |= 1;
+                } else if (hin > 0) {
+                    Ph |= 1;
+                }
+                pv[b] = Mh | ~(Xv | Ph);
+                mv[b] = Ph & Xv;
+                hin = hout;
+            }
+            score += hin;
+
+            if (score <= max_err) {
+                size_t gap = (j > expect_end) ? j - expect_end : expect_end - j;
+                size_t best_gap = (end > expect_end) ? end - expect_end : expect_end - end;
+                if (!found || score < dist || (score == dist && gap < best_gap)) {
+                    found = true;
+                    dist = score;
+                    end = j;
+                }
+            }
+        }
+        return found;
+    }
+
+    // ref[lo, end]에서 end로 끝나는 거리 dist 정렬의 시작 위치와 CIGAR (out에 추가)
+    // 거리 max_err 이하 경로는 대각선 (j - i)이 2*max_err+1 폭 안에 있으므로 그 밴드만 계산
+    size_t traceback(std::string_view read, std::string_view ref, size_t lo, size_t end,
+                     int dist, int max_err, std::vector<uint32_t>& out) {
+        const int INF = 1 << 28;
+        long m  = static_cast<long>(read.size());
+        long bw = 2L * max_err + 1;                          // 밴드 폭
+        long ws = static_cast<long>(end) + 1 - (m + max_err); // 밴드 0번 대각선의 레퍼런스 시작
+        auto cell = [&](long i, long k) -> int& { return band[i * bw + k]; };
+        auto ref_at = [&](long j) -> int {                   // j = 밴드 열 (1부터), 범위 밖은 불일치
+            long p = ws + j - 1;
+            return (p >= static_cast<long>(lo) && p <= static_cast<long>(end)) ? base_idx(ref[p]) : -2;
+        };
+
+        band.assign(static_cast<size_t>((m + 1) * bw), INF);
+        for (long k = 0; k < bw; k++) {
+            cell(0, k) = (ws + k >= static_cast<long>(lo)) ? 0 : INF; // lo 이전에서는 시작 불가
+        }
+        for (long i = 1; i <= m; i++) {
+            int rc = base_idx(read[i - 1]);
+            for (long k = 0; k < bw; k++) {
+                long j = i + k;
+                int best = cell(i - 1, k) + ((rc >= 0 && rc == ref_at(j)) ? 0 : 1); // 대각선
+                if (k + 1 < bw) {
+                    best = std::min(best, cell(i - 1, k + 1) + 1);  // 삽입: 리드만 진행
+                }
+                if (k > 0) {
+                    best = std::min(best, cell(i, k - 1) + 1);      // 삭제: 레퍼런스만 진행
+                }
+                cell(i, k) = std::min(best, INF);
+            }
+        }
+        if (cell(m, max_err) != dist) {
+            throw std::logic_error("traceback: band score differs from bit-parallel score");
+        }
+
+        // 끝에서 시작으로: 대각선, 삽입, 삭제 순으로 선호
+        ops.clear();
+        long i = m, k = max_err;
+        while (i > 0) {
+            int cur = cell(i, k);
+            int rc = base_idx(read[i - 1]);
+            if (cur == cell(i - 1, k) + ((rc >= 0 && rc == ref_at(i + k)) ? 0 : 1)) {
+                ops.push_back(OP_M);
+                i--;
+            } else if (k + 1 < bw && cur == cell(i - 1, k + 1) + 1) {
+                ops.push_back(OP_I);
+                i--;
+                k++;
+            } else {
+                ops.push_back(OP_D);
+                k--;
+            }
+        }
+
+        // 같은 연산끼리 묶어서 CIGAR로
+        for (size_t t = ops.size(); t > 0;) {
+            uint32_t op = ops[t - 1];
+            uint32_t len = 0;
+            while (t > 0 && ops[t - 1] == op) {
+                len++;
+                t--;
+            }
+            out.push_back((len << 2) | op);
+        }
+        return static_cast<size_t>(ws + k);
+    }
+
+private:
+    std::vector<uint64_t> peq;  // 염기별 리드 일치 비트 (4 x 블록 수)
+    std::vector<uint64_t> pv;   // 세로 +1 차이 비트
+    std::vector<uint64_t> mv;   // 세로 -1 차이 비트
+    std::vector<int>      band; // 밴드 DP
+    std::vector<uint32_t> ops;  // 역순 연산
+};
+
+} // namespace align
+
+#endif // ALIGN_HPP
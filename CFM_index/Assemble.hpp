@@ -3,75 +3,164 @@
 
 #include <chrono>
 #include <string>
-#include <vector>
-#include <array>
 #include <fstream>
+#include <memory>
 #include <algorithm>
+#include <stdexcept>
 #include "IOUtils.hpp"
+#include "Options.hpp"
 #include "FMIndex.hpp"
+#include "ShardedIndex.hpp"
+#include "Mapping.hpp"
+#include "Bench.hpp"
+#include "Report.hpp"
 
 using namespace std;
 using namespace chrono;
 
-// 어셈블 함수
-inline string assemble_reads(const string& reference, const vector<string>& reads, int max_err) {
-    size_t ref_len  = reference.size();
-    size_t read_cnt = reads.size();
+// 인덱스 구축 뒤의 어셈블: 매핑, 투표, 컨센서스 저장, 타이밍 로그
+template <typename Index>
+inline void assemble_with(Index& fm, const string& reference, const io::MappedFile& read_file,
+                          const string& out_path, int max_err, const opt::Options& opts,
+                          long long build_ms, bool loaded) {
+    size_t ref_len = reference.size();
+    if ((opts.scheme || opts.prune) && !fm.has_reverse()) {
+        throw runtime_error("index has no reverse BWT; rebuild it with --search scheme or --prune");
+    }
+    MapConfig mc;
+    mc.max_err  = max_err;
+    mc.mode     = opts.scheme ? SearchMode::Scheme : SearchMode::Backtrack;
+    mc.prune    = opts.prune;
+    mc.threads  = opts.threads;
+    mc.batch    = opts.batch;
+    mc.reference  = reference;
+    mc.anchor     = opts.anchor;
+    mc.exhaustive = opts.exhaustive;
+    mc.indels     = opts.indels;
+    mc.best        = opts.best;
+    mc.second_best = opts.second_best;
+    mc.max_hits    = opts.max_hits ? opts.max_hits : SIZE_MAX;
+    mc.multi       = opts.multi;
+    mc.fused       = opts.fused;
+    unique_ptr<StrataLog> strata_log;
+    if (!opts.strata_path.empty()) {
+        strata_log = make_unique<StrataLog>(opts.strata_path);
+        mc.strata = strata_log.get();
+    }
 
-    // FM-index 구축
-    auto t_build_start = high_resolution_clock::now();
-    FMIndex fm(reference);
-    auto t_build_end   = high_resolution_clock::now();
-    long long build_ms = duration_cast<milliseconds>(t_build_end - t_build_start).count();
+    // 측정용 반복 실행 (--scaling은 본 매핑 전, 나머지는 뒤)
+    Bench<Index> bench(fm, read_file, mc, ref_len, opts);
+    bench.before();
 
-    // 리드 매핑
-    auto t_map_start = high_resolution_clock::now();
-    vector<vector<size_t>> positions(read_cnt);
-    for (size_t i = 0; i < read_cnt; ++i) {
-        positions[i] = fm.locate(reads[i], max_err);
+    // 파싱, 매핑, 투표를 겹쳐서 실행한 뒤 컨센서스 문자열 생성
+    // 창 모드: 매핑 결과를 위치 구간별로 기록하고, 구간 순서로 창 크기 투표 표에 모아 확정된 부분부터 출력
+    PipelineTimes times;
+    RunStats rs;
+    high_resolution_clock::time_point t_call_start;
+    if (opts.window) {
+        bins::HitBins hb(read_file.data(), ref_len, opts.window, opts.bin_memory << 20);
+        run_pipeline(fm, read_file, mc, hb, ref_len, times);
+        t_call_start = high_resolution_clock::now();
+        ofstream ofs(out_path);
+        if (!ofs) {
+            throw runtime_error("open fail: " + out_path);
+        }
+        rs.vote_mem  = call_windowed(hb, ref_len, opts.window, ofs);
+        rs.bins      = hb.bins();
+        rs.bins_used = hb.used_bins();
+        rs.bin_mem   = hb.buffer_peak();
+        rs.spilled   = hb.spilled();
+    } else {
+        consensus::VoteTable votes(ref_len);
+        run_pipeline(fm, read_file, mc, votes, ref_len, times);
+        t_call_start = high_resolution_clock::now();
+        io::write_text(out_path, votes.call());
+        rs.vote_mem = votes.bytes();
     }
-    auto t_map_end = high_resolution_clock::now();
-    long long map_ms = duration_cast<milliseconds>(t_map_end - t_map_start).count();
+    auto t_call_end = high_resolution_clock::now();
+    rs.call_ms = duration_cast<milliseconds>(t_call_end - t_call_start).count();
+    rs.kmer_k     = fm.kmer_k();
+    rs.kmer_bytes = fm.kmer_bytes();
+    rs.peak_rss   = io::peak_rss_bytes();
 
-    // 다수결 어셈블
-    vector<array<int, 256>> vote(ref_len);
-    for (size_t i = 0; i < read_cnt; ++i) {
-        const auto& read = reads[i];
-        for (size_t pos : positions[i]) {
-            // 위치가 레퍼런스 범위를 벗어나면 건너뜀
-            if (pos + read.size() > ref_len) {
-                continue;
-            }
-            for (size_t j = 0; j < read.size(); ++j) {
-                unsigned char c = static_cast<unsigned char>(read[j]);
-                vote[pos + j][c]++;
-            }
+    bench.after();
+    write_timing(fm, opts, max_err, ref_len, build_ms, loaded, times, rs, bench.results());
+}
+
+// 가장 긴 리드 길이 (매핑 전에 한 번 훑음)
+inline size_t longest_read(const io::MappedFile& read_file) {
+    io::ReadScanner scanner(read_file.data(), read_file.size());
+    vector<string_view> reads;
+    size_t longest = 0;
+    while (scanner.next(reads, 4096)) {
+        for (auto r : reads) {
+            longest = max(longest, r.size());
         }
     }
+    return longest;
+}
 
-    string assembled(ref_len, 'N');
-    for (size_t i = 0; i < ref_len; ++i) {
-        auto& counts = vote[i];
-        auto it = max_element(counts.begin(), counts.end());
-        if (*it > 0) {
-            assembled[i] = static_cast<char>(distance(counts.begin(), it));
+// 어셈블 함수: 컨센서스를 out_path에 저장 (창 모드이면 확정된 구간부터 바로 씀)
+inline void assemble_reads(const string& reference, const string& read_path, const string& out_path,
+                           int max_err, const opt::Options& opts) {
+    if (opts.indels && opts.anchor) {
+        throw invalid_argument("--indels cannot be combined with --anchor or --exhaustive");
+    }
+    if (opts.best && (opts.anchor || opts.indels)) {
+        throw invalid_argument("--best cannot be combined with --anchor or --indels");
+    }
+    if (opts.max_hits && opts.indels) {
+        throw invalid_argument("--max-hits cannot be combined with --indels");
+    }
+    if (opts.multi != opt::MULTI_ALL && (opts.anchor || opts.indels)) {
+        throw invalid_argument("--multi cannot be combined with --anchor or --indels");
+    }
+    size_t ref_len = reference.size();
+    io::MappedFile read_file = io::map_read_file(read_path);
+    bool sharded = opts.shards > 1;
+    // 겹침보다 긴 리드는 샤드 경계에 걸친 hit를 놓치므로, 매핑 도중이 아니라 구축 전에 거부
+    if (sharded) {
+        size_t longest = longest_read(read_file);
+        if (longest > opts.shard_overlap) {
+            throw invalid_argument("longest read (" + to_string(longest) + " bases) exceeds --shard-overlap "
+                                   + to_string(opts.shard_overlap) + "; raise --shard-overlap to at least "
+                                   + to_string(longest));
         }
     }
 
-    auto t_asm_end = high_resolution_clock::now();
-    long long asm_ms = duration_cast<milliseconds>(t_asm_end - t_map_end).count();
-
-    // 타이밍 로그
-    long long total_ms = build_ms + map_ms + asm_ms;
-    ofstream tfs("cfmindex_timing.txt");
-    if (tfs) {
-        tfs << "FM-index build time     : " << build_ms  << " ms\n";
-        tfs << "Read mapping time       : " << map_ms    << " ms\n";
-        tfs << "Consensus assembly time : " << asm_ms    << " ms\n";
-        tfs << "Total pipeline time     : " << total_ms  << " ms\n";
+    // FM-index 구축 (인덱스 파일이 주어지면 매핑 로드), --shards이면 겹치는 샤드마다 인덱스
+    auto t_build_start = high_resolution_clock::now();
+    bool loaded = !opts.index_path.empty();
+    size_t index_len = index_span(ref_len, opts);
+    size_t kmer_k = (opts.kmer == opt::KMER_AUTO) ? kmer::auto_k(index_len + 1) : opts.kmer;
+    IndexConfig cfg;
+    cfg.sa_rate = opts.sa_rate;
+    cfg.bidirectional = opts.scheme || opts.prune;
+    cfg.kmer_k = kmer_k;
+    auto build_done = [&](auto& fm) {
+        // 로드한 인덱스는 저장된 표와 SA 샘플을 쓰고, --kmer나 --sa-rate로 다른 값을 지정한 경우만 다시 구축
+        if (loaded && opts.kmer != opt::KMER_AUTO && opts.kmer != fm.kmer_k()) {
+            fm.build_kmers(opts.kmer);
+        }
+        if (loaded && opt::given(opts, "--sa-rate") && opts.sa_rate != fm.sa_rate()) {
+            fm.resample_sa(opts.sa_rate);
+        }
+        auto t_build_end   = high_resolution_clock::now();
+        long long build_ms = duration_cast<milliseconds>(t_build_end - t_build_start).count();
+        assemble_with(fm, reference, read_file, out_path, max_err, opts, build_ms, loaded);
+    };
+    if (sharded) {
+        ShardedIndex fm = loaded ? ShardedIndex::load(opts.index_path, reference, opts.shards, opts.shard_overlap)
+                                 : ShardedIndex(reference, cfg, opts.shards, opts.shard_overlap, opts.threads);
+        // 매핑 스레드가 코어를 다 쓰지 않을 때만 남는 코어로 샤드를 동시에 검색 (기본)
+        fm.set_query_threads(opts.shard_threads ? opts.shard_threads
+                                                : par::default_threads() / opts.threads);
+        build_done(fm);
+    } else {
+        FMIndex fm = loaded ? FMIndex::load(opts.index_path, store::checksum(reference))
+                            : FMIndex(reference, cfg);
+        build_done(fm);
     }
-
-    return assembled;
 }
 
 #endif // ASSEMBLE_HPP
@@ -0,0 +1,146 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Mapping.hpp"
+
+// 인덱스 하나가 덮는 최대 길이: 샤드 인덱스이면 가장 긴 샤드 (k-mer 표 크기 기준)
+inline size_t index_span(size_t ref_len, const opt::Options& opts) {
+    return (opts.shards > 1) ? ShardedIndex::max_span(ref_len, opts.shards, opts.shard_overlap) : ref_len;
+}
+
+// 리드당 검색 시간 (매퍼 busy 시간 / 리드 수, us)
+inline double per_read_us(const PipelineTimes& t) {
+    return t.read_cnt ? static_cast<double>(t.map.busy_us) / t.read_cnt : 0.0;
+}
+
+// SA 샘플링 간격 하나의 측정 (--sa-bench)
+struct SaPoint {
+    size_t rate;
+    size_t bytes;       // 샘플링 SA 메모리
+    double per_read_us;
+};
+
+// 측정용 반복 실행 결과: 옵션이 꺼진 측정은 비어 있음
+struct BenchResults {
+    vector<pair<size_t, long long>> scaling; // (매퍼 스레드 수, 스트리밍 시간 ms) (--scaling)
+    bool   pruned = false;                   // 가지치기 없는 매핑을 측정함 (--prune-bench)
+    size_t unpruned_nodes = 0;
+    double unpruned_us = 0.0;
+    vector<pair<size_t, double>> kmer;       // (k, 리드당 검색 시간 us) (--kmer-bench)
+    vector<SaPoint> sa;                      // (--sa-bench)
+};
+
+// 본 매핑 앞뒤의 측정용 반복 실행: 결과 컨센서스는 버리고 시간과 노드 수만 모음
+// 인덱스를 바꾸는 측정(k-mer 표, SA 샘플링)은 끝나면 원래 설정으로 되돌림
+template <typename Index>
+class Bench {
+public:
+    Bench(Index& fm, const io::MappedFile& read_file, const MapConfig& mc, size_t ref_len,
+          const opt::Options& opts)
+        : fm(fm), read_file(read_file), mc(mc), ref_len(ref_len), opts(opts) {}
+
+    // 본 매핑 전: 스레드 수 스케일링 (--scaling)
+    void before() {
+        if (opts.scaling) {
+            scaling_runs();
+        }
+    }
+
+    // 본 매핑 뒤: 가지치기, k-mer 표, SA 샘플링 간격 비교
+    void after() {
+        if (opts.prune_bench) {
+            prune_run();
+        }
+        if (opts.kmer_bench) {
+            kmer_runs();
+        }
+        if (opts.sa_bench) {
+            sa_runs();
+        }
+    }
+
+    const BenchResults& results() const {
+        return res;
+    }
+
+private:
+    Index&                fm;
+    const io::MappedFile& read_file;
+    const MapConfig&      mc;
+    size_t                ref_len;
+    const opt::Options&   opts;
+    BenchResults          res;
+
+    // 측정용 실행 한 번 (창 모드이면 구간 기록에 모아 메모리 한도 유지, 계층 기록도 안 함)
+    void run(MapConfig smc, PipelineTimes& st) {
+        smc.strata = nullptr;
+        if (opts.window) {
+            bins::HitBins scratch(read_file.data(), ref_len, opts.window, opts.bin_memory << 20);
+            run_pipeline(fm, read_file, smc, scratch, ref_len, st);
+        } else {
+            consensus::VoteTable scratch(ref_len);
+            run_pipeline(fm, read_file, smc, scratch, ref_len, st);
+        }
+    }
+
+    // 1, 2, 4, ... 매퍼 스레드와 --threads 자체
+    void scaling_runs() {
+        for (size_t t = 1;; t = min(t * 2, opts.threads)) {
+            PipelineTimes st;
+            MapConfig smc = mc;
+            smc.threads = t;
+            run(smc, st);
+            res.scaling.emplace_back(t, st.wall_ms);
+            if (t == opts.threads) {
+                break;
+            }
+        }
+    }
+
+    // 가지치기 없이 같은 입력을 다시 매핑하여 노드 수와 검색 시간 비교
+    void prune_run() {
+        PipelineTimes st;
+        MapConfig umc = mc;
+        umc.prune = false;
+        run(umc, st);
+        res.pruned = true;
+        res.unpruned_nodes = st.nodes;
+        res.unpruned_us = per_read_us(st);
+    }
+
+    // k별 리드당 검색 시간: 표 칸 수가 인덱스 (샤드이면 가장 긴 샤드) 행 수 이하인 k만 측정
+    void kmer_runs() {
+        size_t k0 = fm.kmer_k();
+        size_t rows = index_span(ref_len, opts) + 1;
+        for (size_t k : {0, 8, 10, 12, 14}) {
+            if (k && (size_t(1) << (2 * k)) > rows) {
+                break;
+            }
+            fm.build_kmers(k);
+            PipelineTimes st;
+            run(mc, st);
+            res.kmer.emplace_back(k, per_read_us(st));
+        }
+        fm.build_kmers(k0);
+    }
+
+    // SA 샘플링 간격별 메모리와 리드당 검색 시간
+    void sa_runs() {
+        size_t rate = fm.sa_rate();
+        for (size_t r : {1, 16, 32, 64}) {
+            fm.resample_sa(r);
+            PipelineTimes st;
+            run(mc, st);
+            res.sa.push_back({r, fm.sa_bytes(), per_read_us(st)});
+        }
+        fm.resample_sa(rate);
+    }
+};
+
+#endif // BENCH_HPP
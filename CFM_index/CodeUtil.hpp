@@ -3,8 +3,13 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <stdexcept>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CODEUTIL_SSE2 1
+#endif
 
 namespace code {
 
@@ -55,7 +60,7 @@ inline int code_to_idx(uint8_t code)
 }
 
 // 문자열 -> 팩킹 변환
-inline std::vector<uint8_t> pack_codes(const std::string& seq)
+inline std::vector<uint8_t> pack_codes(std::string_view seq)
 {
     std::vector<uint8_t> res;                  // 결과 벡터
     res.reserve((seq.size() + 1) / 2);
@@ -67,6 +72,15 @@ inline std::vector<uint8_t> pack_codes(const std::string& seq)
     return res;
 }
 
+// 문자열 -> 코드 벡터 (out 재사용, 할당 없음)
+inline void encode_into(std::string_view seq, std::vector<uint8_t>& out)
+{
+    out.resize(seq.size());
+    for (size_t i = 0; i < seq.size(); i++) {
+        out[i] = encode_base(seq[i]);
+    }
+}
+
 // 팩킹 -> 코드 벡터 변환
 inline std::vector<uint8_t> unpack_codes(const std::vector<uint8_t>& packed)
 {
@@ -91,6 +105,31 @@ inline std::string to_string(const std::vector<uint8_t>& packed)
     return seq;
 }
 
+// 두 염기 문자열 a[0, n), b[0, n)의 다른 문자 수가 max_err 이하인지 확인
+// 16문자씩 비교하고 허용 수를 넘으면 바로 중단
+inline bool hamming_within(const char* a, const char* b, size_t n, int max_err)
+{
+    int diff = 0;
+    size_t i = 0;
+#ifdef CODEUTIL_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned ne = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) & 0xFFFFu;
+        for (; ne; ne &= ne - 1) {
+            diff++;
+        }
+        if (diff > max_err) {
+            return false;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        diff += (a[i] != b[i]);
+    }
+    return diff <= max_err;
+}
+
 } // namespace code
 
 #endif // CODEUTIL_HPP
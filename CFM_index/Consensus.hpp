@@ -0,0 +1,160 @@
+#ifndef CONSENSUS_HPP
+#define CONSENSUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONSENSUS_SSE2 1
+#endif
+
+namespace consensus {
+
+// 투표 슬롯: 기존 256칸 max_element 동점 처리(작은 ASCII 우선)와 같은 순서
+constexpr int SLOTS = 5;
+constexpr char SLOT_BASE[SLOTS] = {'A', 'C', 'G', 'N', 'T'};
+constexpr uint16_t COUNT_MAX = 0xFFFF; // 포화 카운터 최댓값
+
+// 염기 -> 슬롯 (A,C,G,T 외에는 'N')
+inline int base_slot(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 4;
+        default:  return 3;
+    }
+}
+
+// 염기별 16bit 포화 카운터 (struct-of-arrays)
+class VoteTable {
+public:
+    explicit VoteTable(size_t ref_len) : len(ref_len) {
+        for (auto& c : counts) {
+            c.assign(ref_len, 0);
+        }
+    }
+
+    // 한 염기 투표
+    inline void add(size_t pos, char base) {
+        uint16_t& c = counts[base_slot(base)][pos];
+        if (c != COUNT_MAX) {
+            c++;
+        }
+    }
+
+    // 한 염기에 weight 표 (포화)
+    inline void add(size_t pos, char base, uint16_t weight) {
+        uint16_t& c = counts[base_slot(base)][pos];
+        c = (c > COUNT_MAX - weight) ? COUNT_MAX : static_cast<uint16_t>(c + weight);
+    }
+
+    // 리드 전체를 pos부터 투표
+    template <typename Seq>
+    inline void add_read(size_t pos, const Seq& read) {
+        for (size_t j = 0; j < read.size(); j++) {
+            add(pos + j, read[j]);
+        }
+    }
+
+    // 리드 전체를 pos부터 weight 표씩 투표
+    template <typename Seq>
+    inline void add_read(size_t pos, const Seq& read, uint16_t weight) {
+        for (size_t j = 0; j < read.size(); j++) {
+            add(pos + j, read[j], weight);
+        }
+    }
+
+    // 정렬된 리드를 pos부터 CIGAR (길이 << 2 | 0=M, 1=I, 2=D)를 따라 투표
+    // M은 레퍼런스 위치마다 리드 염기 투표, I는 레퍼런스에 자리가 없으므로 건너뜀, D는 투표 없이 위치만 진행
+    template <typename Seq>
+    inline void add_alignment(size_t pos, const Seq& read, const uint32_t* ops, size_t n_ops) {
+        size_t r = 0;
+        for (size_t k = 0; k < n_ops; k++) {
+            uint32_t len = ops[k] >> 2;
+            switch (ops[k] & 0x3) {
+                case 0:
+                    for (uint32_t j = 0; j < len; j++) {
+                        add(pos++, read[r++]);
+                    }
+                    break;
+                case 1:
+                    r += len;
+                    break;
+                default:
+                    pos += len;
+                    break;
+            }
+        }
+    }
+
+    // 위치별 최다 득표 염기 (득표 없으면 'N')
+    std::string call() const {
+        return call(0, len);
+    }
+
+    // [from, to) 위치의 최다 득표 염기
+    std::string call(size_t from, size_t to) const {
+        std::string out(to - from, 'N');
+        size_t i = from;
+#ifdef CONSENSUS_SSE2
+        // 8칸씩: 부호 없는 비교를 위해 0x8000 xor 후 부호 있는 비교
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i none = _mm_set1_epi16('N');
+        for (; i + 8 <= to; i += 8) {
+            __m128i best = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts[0].data() + i));
+            __m128i sel  = _mm_set1_epi16(SLOT_BASE[0]);
+            for (int s = 1; s < SLOTS; s++) {
+                __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts[s].data() + i));
+                __m128i gt = _mm_cmpgt_epi16(_mm_xor_si128(v, bias), _mm_xor_si128(best, bias));
+                best = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, best));
+                sel  = _mm_or_si128(_mm_and_si128(gt, _mm_set1_epi16(SLOT_BASE[s])),
+                                    _mm_andnot_si128(gt, sel));
+            }
+            __m128i empty = _mm_cmpeq_epi16(best, zero);
+            sel = _mm_or_si128(_mm_and_si128(empty, none), _mm_andnot_si128(empty, sel));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[i - from]), _mm_packus_epi16(sel, sel));
+        }
+#endif
+        for (; i < to; i++) {
+            uint16_t best = counts[0][i];
+            int slot = 0;
+            for (int s = 1; s < SLOTS; s++) {
+                if (counts[s][i] > best) {
+                    best = counts[s][i];
+                    slot = s;
+                }
+            }
+            if (best > 0) {
+                out[i - from] = SLOT_BASE[slot];
+            }
+        }
+        return out;
+    }
+
+    // 앞 n 위치를 버리고 나머지를 앞으로 당김 (뒤는 0): 창으로 쓸 때 n만큼 전진
+    void shift(size_t n) {
+        n = std::min(n, len);
+        for (auto& c : counts) {
+            std::copy(c.begin() + n, c.end(), c.begin());
+            std::fill(c.end() - n, c.end(), 0);
+        }
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return SLOTS * len * sizeof(uint16_t);
+    }
+
+private:
+    size_t len;                                // 레퍼런스 길이
+    std::vector<uint16_t> counts[SLOTS];       // 슬롯별 득표 수
+};
+
+} // namespace consensus
+
+#endif // CONSENSUS_HPP
@@ -4,22 +4,97 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <array>
 #include <algorithm>
-#include <tuple>
-#include <stack>
+#include <cstring>
+#include <stdexcept>
 #include "CodeUtil.hpp"
+#include "IOUtils.hpp"
+#include "Storage.hpp"
+#include "SuffixArray.hpp"
+#include "OccTable.hpp"
+#include "SampledSA.hpp"
+#include "KmerTable.hpp"
 
 using namespace std;
 
 static constexpr uint8_t SENT_CODE = 0x0; // 센티넬: $
 static const array<uint8_t,4> ALPHABET = { 0x1, 0x5, 0x9, 0xD }; // A, C, G, T
 
+// 인덱스 파일 형식
+static constexpr char     INDEX_MAGIC[8] = "CFMIDX";
+static constexpr uint32_t INDEX_VERSION  = 3;
+static constexpr uint32_t FLAG_REVERSE   = 0x1; // 역방향 BWT 포함
+static constexpr uint32_t FLAG_KMERS     = 0x2; // k-mer 구간 표 포함
+
+// 인덱스 파일 헤더
+struct IndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t word_size;     // sizeof(size_t)
+    uint64_t ref_checksum;  // 레퍼런스 FNV-1a 체크섬
+    uint64_t length;        // BWT 길이
+    uint32_t flags;         // FLAG_*
+    uint32_t reserved;
+};
+
+// 인덱스 구축 설정
+struct IndexConfig {
+    size_t sa_rate = 1;            // SA 샘플링 간격
+    bool   bidirectional = false;  // 역방향 BWT 구축 (검색 스킴용)
+    size_t kmer_k = 0;             // k-mer 구간 표 길이 (0 = 사용 안 함)
+};
+
+// 검색 방식
+enum class SearchMode {
+    Backtrack,  // 패턴 끝에서부터 모든 mismatch를 백트래킹
+    Scheme,     // 양방향 인덱스 + 비둘기집 검색 스킴
+};
+
+// 검색 스택 항목
+struct SearchFrame {
+    int    idx;    // 다음에 맞출 패턴 위치
+    size_t left;   // SA 구간 시작
+    size_t right;  // SA 구간 끝
+    int    errs;   // 남은 mismatch 허용 수
+};
+
+// 양방향 검색 스택 항목
+struct BiFrame {
+    size_t step;   // 스킴 순서상 다음 단계
+    size_t lf;     // 정방향 SA 구간 시작
+    size_t lr;     // 역방향 SA 구간 시작
+    size_t size;   // 구간 크기
+    int    errs;   // 남은 mismatch 허용 수
+};
+
+// 검색 작업 공간: 스레드마다 하나씩 두고 재사용하면 검색 중 할당 없음
+struct SearchContext {
+    SearchMode          mode = SearchMode::Backtrack;
+    vector<SearchFrame> stack;    // DFS 스택
+    vector<BiFrame>     bi_stack; // 검색 스킴 스택
+    vector<size_t>      found;    // 검색 스킴: 이미 찾은 결과 구간 시작 (정렬됨)
+    vector<uint8_t>     pattern;  // 인코딩된 패턴
+    vector<size_t>      hits;     // 결과 위치
+    bool                intervals_only = false; // 위치 대신 SA 구간만 기록 (SA 조회 없음)
+    vector<pair<size_t, size_t>> intervals; // 결과 SA 구간 [left, right), 정렬 및 병합됨
+    size_t              rows = 0; // 결과 위치 수 (검색 중에는 지금까지 찾은 서로 다른 위치 수)
+    size_t              nodes = 0; // 누적 확장 노드 수
+    bool                prune = false; // 하한 배열로 가지치기 (역방향 BWT 필요)
+    vector<int>         bound;    // bound[i] = pattern[0..i]에 필요한 최소 mismatch 수
+    size_t              max_hits = SIZE_MAX; // hit 상한 (서로 다른 위치 수 기준, 검색 방식과 무관)
+    bool                capped = false;  // 상한을 넘어 검색을 중단했는지 (hits는 비움)
+    vector<size_t>      merged;   // 샤드 인덱스: 샤드별 결과를 전역 위치로 모음
+    bool                merged_capped = false; // 샤드 인덱스: 어느 샤드에서든 상한 초과
+    vector<SearchContext> shard_ctx; // 샤드 인덱스 병렬 검색: 샤드별 작업 공간
+};
+
 class FMIndex {
 public:
-    // 생성자
-    explicit FMIndex(const string& reference) {
+    // 생성자: cfg.sa_rate 간격으로 SA 샘플링, cfg.bidirectional이면 역방향 BWT도 구축
+    explicit FMIndex(const string& reference, const IndexConfig& cfg = IndexConfig()) {
         string ref_with_sent = reference + "$";
         vector<uint8_t> codes;
         codes.reserve(ref_with_sent.size());
@@ -27,96 +102,229 @@ public:
             codes.push_back(code::encode_base(c));
         }
 
-        // 페킹
-        vector<uint8_t> packed_text;
-        packed_text.reserve((codes.size() + 1) / 2);
-        for (size_t i = 0; i < codes.size(); i += 2) {
-            uint8_t high = codes[i];
-            uint8_t low  = (i + 1 < codes.size()) ? codes[i + 1] : SENT_CODE;
-            packed_text.push_back(static_cast<uint8_t>((high << 4) | (low & 0xF)));
-        }
-
         length = ref_with_sent.size();
-        build_sa(packed_text);
-        build_bwt(packed_text);
+        build_sa(codes);
+        build_bwt(pack_text(codes));
         build_c();
         build_occ();
+        build_ssa(cfg.sa_rate);
+        if (cfg.bidirectional) {
+            build_reverse(codes);
+        }
+        build_kmers(cfg.kmer_k);
+    }
+
+    // k-mer 구간 표 (재)구축: 로드한 인덱스에도 적용 가능
+    void build_kmers(size_t k) {
+        kmers.build(k, occ, C, length);
+    }
+
+    // SA 샘플 (재)구축: LF로 텍스트를 한 바퀴 돌아 전체 SA를 복원한 뒤 rate 간격으로 샘플링, 로드한 인덱스에도 적용 가능
+    void resample_sa(size_t rate) {
+        vector<size_t> full(length);
+        size_t row = 0; // 센티넬 접미사 행
+        for (size_t p = length; p-- > 0;) {
+            full[row] = p;
+            if (p) {
+                row = lf(row);
+            }
+        }
+        ssa.build(std::move(full), rate);
+    }
+
+    // k-mer 표 길이
+    size_t kmer_k() const {
+        return kmers.k();
+    }
+
+    // k-mer 표 메모리 (바이트)
+    size_t kmer_bytes() const {
+        return kmers.bytes();
     }
 
     // 패턴 검색: max_err 만큼 mismatch 허용
-    vector<size_t> locate(const string& pattern, int max_err) const {
-        auto packed_pat = code::pack_codes(pattern);
-        auto pat        = code::unpack_codes(packed_pat);
-        pat.resize(pattern.size());
+    vector<size_t> locate(string_view pattern, int max_err) const {
+        SearchContext ctx;
+        locate(pattern, max_err, ctx);
+        return std::move(ctx.hits);
+    }
 
-        vector<size_t> result;
-        stack<tuple<int, size_t, size_t, int>> stk;
-        stk.emplace(static_cast<int>(pat.size()) - 1, 0, length, max_err);
+    // 패턴 검색 (작업 공간 재사용): 결과는 ctx.hits, 정렬 및 중복 제거됨
+    // hit가 ctx.max_hits를 넘으면 검색을 멈추고 ctx.capped 표시 (hits는 비움)
+    const vector<size_t>& locate(string_view pattern, int max_err, SearchContext& ctx) const {
+        code::encode_into(pattern, ctx.pattern);
+        reset_hits(ctx);
 
-        while (!stk.empty()) {
-            int idx;
-            size_t left, right;
-            int errs;
-            tie(idx, left, right, errs) = stk.top();
-            stk.pop();
+        if (use_scheme(max_err, ctx)) {
+            scheme_search(max_err, ctx);
+        } else {
+            backtrack_search(max_err, ctx);
+        }
+        finish_hits(ctx);
+        return ctx.hits;
+    }
 
-            if (errs < 0 || left >= right) {
-                continue;
-            }
+    // 위치 수만 셈: SA 구간 크기의 합이므로 SA 조회 없음
+    size_t count(string_view pattern, int max_err) const {
+        SearchContext ctx;
+        return count(pattern, max_err, ctx);
+    }
 
-            // 패턴 끝에 도달하면 SA 범위 내 모든 위치를 결과에 추가
-            if (idx < 0) {
-                for (size_t i = left; i < right; i++) {
-                    result.push_back(sa[i]);
-                }
-                continue;
-            }
+    // 위치 수 (작업 공간 재사용)
+    size_t count(string_view pattern, int max_err, SearchContext& ctx) const {
+        locate_intervals(pattern, max_err, ctx);
+        return ctx.rows;
+    }
 
-            uint8_t target = pat[idx];
-            for (uint8_t code_val : ALPHABET) {
-                size_t k    = code::code_to_idx(code_val);
-                size_t base = C[k];
-                size_t nl   = base + (left  > 0 ? occ[left  - 1][k] : 0);
-                size_t nr   = base + (right > 0 ? occ[right - 1][k] : 0);
-                if (nl >= nr) {
-                    continue;
-                }
-                stk.emplace(idx - 1, nl, nr, errs - (code_val != target));
+    // 패턴이 나오는 SA 구간들: 위치가 필요하면 position(row)로 복원
+    const vector<pair<size_t, size_t>>& locate_intervals(string_view pattern, int max_err,
+                                                         SearchContext& ctx) const {
+        bool keep = ctx.intervals_only;
+        ctx.intervals_only = true;
+        locate(pattern, max_err, ctx);
+        ctx.intervals_only = keep;
+        return ctx.intervals;
+    }
+
+    // SA 행 -> 텍스트 위치
+    size_t position(size_t row) const {
+        return sa_value(row);
+    }
+
+    // 콜백 검색: 위치를 결과 배열에 모으지 않고 SA 구간에서 하나씩 복원하여 sink(pos)로 넘김
+    // sink는 템플릿이라 인라인되므로 투표 등을 위치 배열 없이 바로 적용 가능, 위치 수 반환
+    template <typename Sink>
+    size_t locate(string_view pattern, int max_err, SearchContext& ctx, Sink&& sink) const {
+        bool keep = ctx.intervals_only;
+        ctx.intervals_only = true;
+        locate(pattern, max_err, ctx);
+        for_each_hit(ctx, sink);
+        ctx.intervals_only = keep;
+        return ctx.rows;
+    }
+
+    // 끝난 검색의 위치마다 sink(pos): 구간 모드면 SA 행을 그때그때 복원
+    template <typename Sink>
+    void for_each_hit(const SearchContext& ctx, Sink&& sink) const {
+        if (!ctx.intervals_only) {
+            for (size_t pos : ctx.hits) {
+                sink(pos);
             }
+            return;
         }
+        for (const auto& r : ctx.intervals) {
+            for (size_t row = r.first; row < r.second; row++) {
+                sink(sa_value(row));
+            }
+        }
+    }
 
-        sort(result.begin(), result.end());
-        result.erase(unique(result.begin(), result.end()), result.end());
-        return result;
+    // 역방향 BWT 보유 여부
+    bool has_reverse() const {
+        return !occ_rev.empty();
     }
 
-private:
-    size_t length;                    // 레퍼런스 길이
-    vector<size_t> sa;                // 접두사 배열
-    vector<uint8_t> bwt_packed;       // BWT 배열
-    array<uint32_t,5> C;              // 누적 빈도 배열
-    vector<array<uint32_t,5>> occ;    // OCC 테이블
-
-    // SA 구축
-    void build_sa(const vector<uint8_t>& text) {
-        sa.resize(length);
-        vector<size_t> idx(length);
-        for (size_t i = 0; i < length; i++) {
-            idx[i] = i;
+    // OCC 테이블 메모리 (바이트)
+    size_t occ_bytes() const {
+        return occ.bytes();
+    }
+
+    // 인덱스 전체 메모리 (바이트)
+    size_t memory_bytes() const {
+        return ssa.bytes() + occ.bytes() + occ_rev.bytes() + kmers.bytes() + sizeof(C);
+    }
+
+    // SA 샘플링 간격
+    size_t sa_rate() const {
+        return ssa.rate();
+    }
+
+    // 샘플링 SA 메모리 (바이트)
+    size_t sa_bytes() const {
+        return ssa.bytes();
+    }
+
+    // 인덱스 파일 저장
+    void save(const string& path, uint64_t ref_checksum) const {
+        store::Writer w(path);
+        IndexHeader hdr{};
+        memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+        hdr.version      = INDEX_VERSION;
+        hdr.word_size    = sizeof(size_t);
+        hdr.ref_checksum = ref_checksum;
+        hdr.length       = length;
+        hdr.flags        = (has_reverse() ? FLAG_REVERSE : 0) | (kmers.k() ? FLAG_KMERS : 0);
+        w.put(hdr);
+        w.put(C);
+        occ.save(w);
+        ssa.save(w);
+        if (has_reverse()) {
+            occ_rev.save(w);
         }
+        if (kmers.k()) {
+            kmers.save(w);
+        }
+        w.finish();
+    }
 
-        auto codes = code::unpack_codes(text);
-        codes.resize(length);
+    // 인덱스 파일을 읽기 전용으로 매핑하여 로드
+    static FMIndex load(const string& path, uint64_t ref_checksum) {
+        FMIndex fm;
+        fm.file = io::MappedFile(path);
+        store::Reader r(fm.file.data(), fm.file.size());
 
-        sort(idx.begin(), idx.end(),
-            [&](size_t a, size_t b) {
-                return lexicographical_compare(
-                    codes.begin() + a, codes.end(),
-                    codes.begin() + b, codes.end()
-                );
-            }
-        );
-        sa.swap(idx);
+        auto hdr = r.get<IndexHeader>();
+        if (memcmp(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic)) != 0) {
+            throw runtime_error("not a CFM index file: " + path);
+        }
+        if (hdr.version != INDEX_VERSION || hdr.word_size != sizeof(size_t)) {
+            throw runtime_error("unsupported index version: " + path);
+        }
+        if (hdr.ref_checksum != ref_checksum) {
+            throw runtime_error("index does not match reference: " + path);
+        }
+
+        fm.length = static_cast<size_t>(hdr.length);
+        fm.C = r.get<array<uint64_t,5>>();
+        fm.occ.load(r);
+        fm.ssa.load(r);
+        if (hdr.flags & FLAG_REVERSE) {
+            fm.occ_rev.load(r);
+        }
+        if (hdr.flags & FLAG_KMERS) {
+            fm.kmers.load(r, fm.length);
+        }
+        return fm;
+    }
+
+private:
+    FMIndex() = default;
+
+    io::MappedFile file;              // 로드 시 매핑된 인덱스 파일
+    size_t length = 0;                // 레퍼런스 길이
+    vector<size_t> sa;                // 접두사 배열 (구축 중에만 사용)
+    suffix::SampledSA ssa;            // 샘플링 SA
+    vector<uint8_t> bwt_packed;       // BWT 배열 (구축 중에만 사용)
+    array<uint64_t,5> C;              // 누적 빈도 배열 (2^32 염기 이상도 가능하도록 64bit)
+    occ::OccTable occ;                // OCC 테이블 (블록 랭크 사전)
+    occ::OccTable occ_rev;            // 역방향 텍스트의 OCC 테이블 (양방향 검색용)
+    kmer::KmerTable kmers;            // k-mer별 SA 구간 (처음 k단계 생략용)
+
+    // 코드 -> 4bit 팩킹 텍스트
+    static vector<uint8_t> pack_text(const vector<uint8_t>& codes) {
+        vector<uint8_t> packed_text;
+        packed_text.reserve((codes.size() + 1) / 2);
+        for (size_t i = 0; i < codes.size(); i += 2) {
+            uint8_t high = codes[i];
+            uint8_t low  = (i + 1 < codes.size()) ? codes[i + 1] : SENT_CODE;
+            packed_text.push_back(static_cast<uint8_t>((high << 4) | (low & 0xF)));
+        }
+        return packed_text;
+    }
+
+    // SA 구축: SA-IS (니블 코드 알파벳 16)
+    void build_sa(const vector<uint8_t>& codes) {
+        sa = suffix::sais(codes, 16);
     }
 
     // BWT 구축
@@ -154,27 +362,329 @@ private:
             size_t k = code::code_to_idx(bwt_code(i));
             C[k]++;
         }
-        uint32_t sum = 0;
+        uint64_t sum = 0;
         for (size_t k = 0; k < C.size(); k++) {
-            uint32_t cnt = C[k];
+            uint64_t cnt = C[k];
             C[k] = sum;
             sum += cnt;
         }
     }
 
-    // OCC 구축
+    // OCC 구축: 2bit BWT가 랭크 블록에 포함되므로 4bit BWT는 해제
     void build_occ() {
-        occ.assign(length, array<uint32_t,5>{});
-        array<uint32_t,5> acc{};
-        for (size_t i = 0; i < length; i++) {
-            size_t k = code::code_to_idx(bwt_code(i));
-            acc[k]++;
-            occ[i] = acc;
+        occ.build(bwt_packed, length);
+        vector<uint8_t>().swap(bwt_packed);
+    }
+
+    // 샘플링 SA 구축: 전체 SA는 넘겨주고 해제
+    void build_ssa(size_t sa_rate) {
+        ssa.build(std::move(sa), sa_rate);
+        vector<size_t>().swap(sa);
+    }
+
+    // 역방향 텍스트(센티넬 제외 후 뒤집고 '$' 추가)의 OCC 구축
+    void build_reverse(const vector<uint8_t>& codes) {
+        vector<uint8_t> rev(codes.rbegin() + 1, codes.rend());
+        rev.push_back(SENT_CODE);
+        build_sa(rev);
+        build_bwt(pack_text(rev));
+        occ_rev.build(bwt_packed, length);
+        vector<uint8_t>().swap(bwt_packed);
+        vector<size_t>().swap(sa);
+    }
+
+    // 백트래킹 검색: 패턴 끝에서부터 모든 심볼로 확장
+    void backtrack_search(int max_err, SearchContext& ctx) const {
+        const auto& pat = ctx.pattern;
+        auto& stk = ctx.stack;
+        const int* lb = nullptr;
+        // 정확 검색은 첫 불일치에서 바로 끝나므로 하한 계산이 오히려 손해
+        if (ctx.prune && has_reverse() && max_err > 0) {
+            compute_bounds(ctx);
+            lb = ctx.bound.data();
+        }
+        stk.clear();
+        if (kmers.k() && pat.size() >= kmers.k()) {
+            seed_from_kmers(max_err, ctx);
+        } else {
+            stk.push_back({static_cast<int>(pat.size()) - 1, 0, length, max_err});
+        }
+
+        while (!stk.empty()) {
+            SearchFrame cur = stk.back();
+            stk.pop_back();
+
+            if (cur.errs < 0 || cur.left >= cur.right) {
+                continue;
+            }
+            // 남은 패턴에 필요한 mismatch가 허용 수보다 많으면 더 내려가지 않음
+            if (lb && cur.idx >= 0 && cur.errs < lb[cur.idx]) {
+                continue;
+            }
+            ctx.nodes++;
+
+            // 패턴 끝에 도달하면 SA 범위 내 모든 위치를 결과에 추가
+            if (cur.idx < 0) {
+                // 상한을 넘으면 SA 조회 없이 검색 중단
+                ctx.rows += cur.right - cur.left;
+                if (ctx.rows > ctx.max_hits) {
+                    cap_hits(ctx);
+                    return;
+                }
+                if (ctx.intervals_only) {
+                    ctx.intervals.emplace_back(cur.left, cur.right);
+                    continue;
+                }
+                for (size_t i = cur.left; i < cur.right; i++) {
+                    ctx.hits.push_back(sa_value(i));
+                }
+                continue;
+            }
+
+            // 허용 mismatch가 남지 않았으면 패턴 염기 하나만 확장 가능
+            uint8_t target = pat[cur.idx];
+            if (cur.errs == 0) {
+                if (target != SENT_CODE && target != code::PAD_CODE) {
+                    int k = code::code_to_idx(target);
+                    size_t nl = C[k] + occ.rank(k, cur.left);
+                    size_t nr = C[k] + occ.rank(k, cur.right);
+                    stk.push_back({cur.idx - 1, nl, nr, 0});
+                }
+                continue;
+            }
+
+            // 구간 양 끝의 랭크를 블록당 한 번에 계산
+            size_t rank_l[5], rank_r[5];
+            occ.rank_all(cur.left,  rank_l);
+            occ.rank_all(cur.right, rank_r);
+
+            for (uint8_t code_val : ALPHABET) {
+                size_t k    = code::code_to_idx(code_val);
+                size_t base = C[k];
+                size_t nl   = base + rank_l[k];
+                size_t nr   = base + rank_r[k];
+                if (nl >= nr) {
+                    continue;
+                }
+                stk.push_back({cur.idx - 1, nl, nr, cur.errs - (code_val != target)});
+            }
         }
     }
 
-    inline uint32_t occ_count(uint8_t code_val, size_t pos) const {
-        return occ[pos][code::code_to_idx(code_val)];
+    // 검색 스킴은 역방향 BWT가 있고 패턴을 max_err + 1 조각으로 나눌 수 있을 때만
+    bool use_scheme(int max_err, const SearchContext& ctx) const {
+        return ctx.mode == SearchMode::Scheme && has_reverse() && max_err > 0
+            && ctx.pattern.size() >= static_cast<size_t>(max_err) + 1;
+    }
+
+    // 검색 시작 전 결과 초기화
+    static void reset_hits(SearchContext& ctx) {
+        ctx.hits.clear();
+        ctx.intervals.clear();
+        ctx.rows = 0;
+        ctx.capped = false;
+    }
+
+    // hit 상한 초과: 검색을 멈추고 결과를 비움
+    static void cap_hits(SearchContext& ctx) {
+        ctx.capped = true;
+        ctx.hits.clear();
+        ctx.intervals.clear();
+        ctx.stack.clear();
+    }
+
+    // 결과 정렬 및 중복 제거: 구간은 검색 스킴의 조각끼리 겹칠 수 있으므로 병합
+    static void finish_hits(SearchContext& ctx) {
+        if (ctx.intervals_only) {
+            auto& iv = ctx.intervals;
+            sort(iv.begin(), iv.end());
+            size_t keep = 0;
+            ctx.rows = 0;
+            for (size_t i = 0; i < iv.size(); i++) {
+                if (keep && iv[i].first <= iv[keep - 1].second) {
+                    iv[keep - 1].second = max(iv[keep - 1].second, iv[i].second);
+                } else {
+                    iv[keep++] = iv[i];
+                }
+            }
+            iv.resize(keep);
+            for (const auto& r : iv) {
+                ctx.rows += r.second - r.first;
+            }
+            return;
+        }
+        auto& result = ctx.hits;
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+        ctx.rows = result.size();
+    }
+
+    // BWA식 하한: 왼쪽부터 역방향 BWT로 정확히 확장하다 끊기면 mismatch 하나가 필요
+    // 서로 겹치지 않는 끊긴 구간 수가 pattern[0..i]의 최소 mismatch 수
+    void compute_bounds(SearchContext& ctx) const {
+        const auto& pat = ctx.pattern;
+        auto& bound = ctx.bound;
+        bound.resize(pat.size());
+        size_t lo = 0, hi = length;
+        int z = 0;
+        for (size_t i = 0; i < pat.size(); i++) {
+            uint8_t c = pat[i];
+            if (c == SENT_CODE || c == code::PAD_CODE) {
+                lo = hi; // ACGT 외 문자는 어디에도 없음
+            } else {
+                int k = code::code_to_idx(c);
+                lo = C[k] + occ_rev.rank(k, lo);
+                hi = C[k] + occ_rev.rank(k, hi);
+            }
+            if (lo >= hi) {
+                z++;
+                lo = 0;
+                hi = length;
+            }
+            bound[i] = z;
+        }
+    }
+
+    // 패턴 끝 k 염기와 max_err 이하로 다른 k-mer의 구간을 표에서 찾아 깊이 k부터 시작
+    void seed_from_kmers(int max_err, SearchContext& ctx) const {
+        const auto& pat = ctx.pattern;
+        size_t k = kmers.k();
+        size_t m = pat.size();
+
+        // 패턴 끝 k 염기의 심볼 (ACGT 외 문자는 -1: 어떤 염기와도 mismatch)
+        int sym[kmer::MAX_K];
+        for (size_t j = 0; j < k; j++) {
+            uint8_t c = pat[m - k + j];
+            sym[j] = (c == SENT_CODE || c == code::PAD_CODE) ? -1 : code::code_to_idx(c) - 1;
+        }
+
+        // 위치별 치환을 깊이 우선으로 열거: (다음 위치, 키, 남은 허용 수)
+        struct Probe {
+            size_t   j;
+            uint32_t key;
+            int      errs;
+        };
+        Probe stk[kmer::MAX_K * 4 + 1];
+        size_t top = 0;
+        stk[top++] = {0, 0, max_err};
+        while (top) {
+            Probe cur = stk[--top];
+            if (cur.j == k) {
+                kmer::Range r = kmers[cur.key];
+                if (r.lo < r.hi) {
+                    ctx.nodes++;
+                    ctx.stack.push_back({static_cast<int>(m - k) - 1, r.lo, r.hi, cur.errs});
+                }
+                continue;
+            }
+            for (int c = 0; c < 4; c++) {
+                int errs = cur.errs - (c != sym[cur.j]);
+                if (errs < 0) {
+                    continue;
+                }
+                uint32_t key = (cur.key << 2) | static_cast<uint32_t>(c);
+                stk[top++] = {cur.j + 1, key, errs};
+            }
+        }
+    }
+
+    // 비둘기집 검색 스킴: mismatch가 max_err개 이하이면 max_err + 1 조각 중 하나는 정확히 일치
+    // 조각 j를 정확히 찾은 뒤 오른쪽 끝까지, 다시 왼쪽 끝까지 확장
+    void scheme_search(int max_err, SearchContext& ctx) const {
+        const auto& pat = ctx.pattern;
+        auto& stk = ctx.bi_stack;
+        auto& result = ctx.hits;
+        size_t m = pat.size();
+        size_t parts = static_cast<size_t>(max_err) + 1;
+        auto& found = ctx.found;
+        found.clear();
+
+        for (size_t j = 0; j < parts; j++) {
+            size_t s = m * j / parts;        // 조각 시작
+            size_t e = m * (j + 1) / parts;  // 조각 끝
+            size_t right_steps = m - s;      // 오른쪽 확장 단계 수
+
+            stk.clear();
+            stk.push_back({0, 0, 0, length, max_err});
+            while (!stk.empty()) {
+                BiFrame cur = stk.back();
+                stk.pop_back();
+                ctx.nodes++;
+
+                if (cur.step == m) {
+                    // 같은 문자열은 여러 조각에서 같은 구간으로 다시 찾아지고, 다른 문자열의 구간은
+                    // 서로 겹치지 않으므로 구간 시작으로 중복을 걸러 상한을 서로 다른 위치 수로 비교
+                    auto at = lower_bound(found.begin(), found.end(), cur.lf);
+                    if (at != found.end() && *at == cur.lf) {
+                        continue;
+                    }
+                    found.insert(at, cur.lf);
+                    ctx.rows += cur.size;
+                    if (ctx.rows > ctx.max_hits) {
+                        cap_hits(ctx);
+                        stk.clear();
+                        return;
+                    }
+                    if (ctx.intervals_only) {
+                        ctx.intervals.emplace_back(cur.lf, cur.lf + cur.size);
+                        continue;
+                    }
+                    for (size_t i = cur.lf; i < cur.lf + cur.size; i++) {
+                        result.push_back(sa_value(i));
+                    }
+                    continue;
+                }
+
+                bool   right  = cur.step < right_steps;
+                size_t p      = right ? s + cur.step : s - 1 - (cur.step - right_steps);
+                bool   exact  = cur.step < e - s;
+                uint8_t target = pat[p];
+
+                // 오른쪽 확장은 역방향 BWT, 왼쪽 확장은 정방향 BWT에서 랭크 계산
+                size_t rank_l[5], rank_r[5];
+                if (right) {
+                    occ_rev.rank_all(cur.lr, rank_l);
+                    occ_rev.rank_all(cur.lr + cur.size, rank_r);
+                } else {
+                    occ.rank_all(cur.lf, rank_l);
+                    occ.rank_all(cur.lf + cur.size, rank_r);
+                }
+
+                // 반대쪽 구간 시작 = 더 작은 심볼의 개수만큼 이동 ('$' 포함)
+                size_t smaller = rank_r[0] - rank_l[0];
+                for (uint8_t code_val : ALPHABET) {
+                    size_t k      = code::code_to_idx(code_val);
+                    size_t cnt    = rank_r[k] - rank_l[k];
+                    size_t before = smaller;
+                    smaller += cnt;
+                    if (cnt == 0) {
+                        continue;
+                    }
+                    bool mismatch = (code_val != target);
+                    int errs = cur.errs - (mismatch ? 1 : 0);
+                    if (errs < 0 || (exact && mismatch)) {
+                        continue;
+                    }
+                    size_t nk = C[k] + rank_l[k];
+                    if (right) {
+                        stk.push_back({cur.step + 1, cur.lf + before, nk, cnt, errs});
+                    } else {
+                        stk.push_back({cur.step + 1, nk, cur.lr + before, cnt, errs});
+                    }
+                }
+            }
+        }
+    }
+
+    // LF 매핑
+    inline size_t lf(size_t row) const {
+        int k = occ.symbol(row);
+        return C[k] + occ.rank(k, row);
+    }
+
+    // SA 값 조회: 샘플이 아니면 LF로 거슬러 올라감
+    inline size_t sa_value(size_t row) const {
+        return ssa.lookup(row, [this](size_t r) { return lf(r); });
     }
 };
 
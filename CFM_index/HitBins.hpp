@@ -0,0 +1,306 @@
+#ifndef HITBINS_HPP
+#define HITBINS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+#include "Align.hpp"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace bins {
+
+// 임시 디렉터리 아래 이 프로세스만 쓰는 새 파일 경로 (프로세스 번호 + 프로세스 안 순번)
+// 같은 디렉터리에서 동시에 돌려도 서로의 기록을 덮어쓰지 않음
+inline std::string temp_spill_path() {
+    static std::atomic<unsigned> seq{0};
+#ifdef _WIN32
+    long long pid = _getpid();
+#else
+    long long pid = getpid();
+#endif
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    for (;;) {
+        std::filesystem::path p = dir / ("cfmindex_bins_" + std::to_string(pid) + "_"
+                                         + std::to_string(seq++) + ".tmp");
+        if (!std::filesystem::exists(p)) {
+            return p.string();
+        }
+    }
+}
+
+// hit 기록 머리: 리드는 매핑된 리드 파일 안의 오프셋으로 가리키므로 리드 복사 없음
+struct Record {
+    uint64_t pos;      // 레퍼런스 위치
+    uint64_t read_off; // 리드 파일 내 오프셋
+    uint32_t read_len; // 리드 길이
+    uint16_t weight;   // 투표 가중치
+    uint16_t n_ops;    // 뒤따르는 CIGAR 연산 수 (0 = 리드 전체를 pos부터)
+};
+
+// 레퍼런스 위치 구간(bin)별 hit 기록: 매핑 순서와 무관하게 구간 순서로 다시 읽기 위함
+// 구간마다 메모리 버퍼를 두고 차면 임시 파일 뒤에 붙여 씀 (구간별 조각 위치 기록)
+// 모든 구간 버퍼의 합이 budget_bytes를 넘으면 큰 구간부터 내보내 절반 아래로 줄이므로
+// 버퍼 메모리는 hit 수나 구간 수와 무관하게 예산 이내
+// 구간 상태(잠금, 버퍼, 조각 목록)는 첫 기록 때 만들고 재생하면 해제하므로,
+// 레퍼런스 길이에 비례해 남는 것은 구간마다 포인터 하나 (ref_len / bin_size * 8 bytes)
+// add_*는 여러 스레드에서 동시에 호출 가능, 임시 파일은 처음 내보낼 때 만들고 소멸자에서 지움 (오류로 풀릴 때 포함)
+class HitBins {
+public:
+    HitBins(const char* file_base, size_t ref_len, size_t bin_size, size_t budget_bytes = size_t(8) << 20,
+            size_t buffer_bytes = size_t(1) << 16)
+        : base(file_base), ref_len(ref_len), bin_size(bin_size),
+          count((ref_len + bin_size - 1) / bin_size + 1), budget_bytes(budget_bytes),
+          buffer_bytes(std::min(buffer_bytes, budget_bytes / 2)),
+          slots(new std::atomic<Slot*>[count]()) {}
+
+    ~HitBins() {
+        for (size_t b = 0; b < count; b++) {
+            delete slots[b].load();
+        }
+        if (spill.is_open()) {
+            spill.close();
+            std::remove(spill_path.c_str());
+        }
+    }
+
+    HitBins(const HitBins&) = delete;
+    HitBins& operator=(const HitBins&) = delete;
+
+    // 리드 전체를 pos부터 weight 표
+    void add_read(size_t pos, std::string_view read, uint16_t weight) {
+        put(pos, read, weight, nullptr, 0, read.size());
+    }
+
+    // 정렬된 리드 (CIGAR)
+    void add_alignment(size_t pos, std::string_view read, const uint32_t* ops, size_t n_ops) {
+        put(pos, read, 1, ops, n_ops, align::ref_span(ops, n_ops));
+    }
+
+    // 구간 수
+    size_t bins() const {
+        return count;
+    }
+
+    // 기록이 하나라도 들어온 구간 수
+    size_t used_bins() const {
+        return used.load();
+    }
+
+    // 기록 하나가 덮는 최대 레퍼런스 길이
+    size_t max_span() const {
+        return span_max.load();
+    }
+
+    // 임시 파일 경로 (아직 내보낸 적이 없으면 빈 문자열)
+    const std::string& path() const {
+        return spill_path;
+    }
+
+    // 임시 파일로 내보낸 바이트
+    uint64_t spilled() const {
+        return spill_size;
+    }
+
+    // 구간 버퍼가 실제로 잡았던 최대 바이트 (할당 용량 합)
+    size_t buffer_peak() const {
+        return held_peak.load();
+    }
+
+    // 구간 버퍼 합 상한
+    size_t budget() const {
+        return budget_bytes;
+    }
+
+    // 구간 b의 기록을 모두 f(pos, read, weight, ops, n_ops)로 재생 (매핑이 끝난 뒤에만)
+    template <typename F>
+    void replay(size_t b, F&& f) {
+        std::unique_ptr<Slot> owned(slots[b].exchange(nullptr));
+        if (!owned) {
+            return;
+        }
+        Slot& s = *owned;
+        std::vector<uint8_t> chunk;
+        for (const auto& c : s.chunks) {
+            chunk.resize(c.second);
+            spill.seekg(static_cast<std::streamoff>(c.first));
+            spill.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(c.second));
+            if (!spill) {
+                throw std::runtime_error("read fail: " + spill_path);
+            }
+            parse(chunk.data(), chunk.size(), f);
+        }
+        parse(s.buf.data(), s.buf.size(), f);
+        release(s);
+    }
+
+private:
+    struct Slot {
+        std::mutex m;
+        std::vector<uint8_t> buf;                          // 아직 내보내지 않은 기록
+        std::vector<std::pair<uint64_t, uint64_t>> chunks; // 임시 파일의 (오프셋, 크기)
+        std::atomic<size_t> cap{0};                        // buf 할당 용량 (잠금 없이 크기 비교용)
+    };
+
+    const char* base;
+    size_t ref_len;
+    size_t bin_size;
+    size_t count;
+    size_t budget_bytes; // 모든 구간 버퍼 합 상한
+    size_t buffer_bytes; // 구간 하나의 버퍼가 이만큼 차면 내보냄
+    std::unique_ptr<std::atomic<Slot*>[]> slots; // 구간 상태, 첫 기록 전에는 nullptr
+    std::atomic<size_t> used{0};                  // 만든 구간 상태 수
+    std::string spill_path;
+    std::fstream spill;
+    std::mutex spill_m;
+    uint64_t spill_size = 0;
+    std::atomic<size_t> span_max{0};
+    std::atomic<size_t> held{0};      // 구간 버퍼 할당 용량 합
+    std::atomic<size_t> held_peak{0}; // 그 최댓값
+    std::mutex evict_m;               // 예산 초과 시 내보내기는 한 스레드만
+    std::vector<std::pair<size_t, size_t>> victims; // 내보낼 후보 (용량, 구간), evict_m 아래에서 재사용
+
+    void put(size_t pos, std::string_view read, uint16_t weight, const uint32_t* ops, size_t n_ops,
+             size_t span) {
+        if (n_ops > UINT16_MAX) {
+            throw std::runtime_error("alignment has too many CIGAR operations");
+        }
+        Record rec{pos, static_cast<uint64_t>(read.data() - base), static_cast<uint32_t>(read.size()),
+                   weight, static_cast<uint16_t>(n_ops)};
+        size_t cur = span_max.load();
+        while (span > cur && !span_max.compare_exchange_weak(cur, span)) {
+        }
+
+        Slot& s = slot(pos / bin_size);
+        {
+            std::lock_guard<std::mutex> lock(s.m);
+            size_t at = s.buf.size();
+            size_t old_cap = s.buf.capacity();
+            s.buf.resize(at + sizeof(Record) + n_ops * sizeof(uint32_t));
+            memcpy(s.buf.data() + at, &rec, sizeof(Record));
+            if (n_ops) {
+                memcpy(s.buf.data() + at + sizeof(Record), ops, n_ops * sizeof(uint32_t));
+            }
+            if (s.buf.capacity() != old_cap) {
+                s.cap = s.buf.capacity();
+                size_t now = held += s.buf.capacity() - old_cap;
+                size_t peak = held_peak.load();
+                while (now > peak && !held_peak.compare_exchange_weak(peak, now)) {
+                }
+            }
+            if (s.buf.size() >= buffer_bytes) {
+                flush(s);
+            }
+        }
+        if (held.load() > budget_bytes) {
+            evict();
+        }
+    }
+
+    // 예산 초과: 용량이 큰 구간부터 내보내 합을 예산의 절반 아래로
+    // 다른 스레드가 내보내는 중이면 기다렸다가 다시 확인하므로 그동안 기록이 더 쌓이지 않음
+    void evict() {
+        std::lock_guard<std::mutex> guard(evict_m);
+        if (held.load() <= budget_bytes) {
+            return;
+        }
+        victims.clear();
+        for (size_t b = 0; b < count; b++) {
+            Slot* p = slots[b].load();
+            size_t c = p ? p->cap.load() : 0;
+            if (c) {
+                victims.emplace_back(c, b);
+            }
+        }
+        std::sort(victims.begin(), victims.end(), std::greater<>());
+        for (const auto& v : victims) {
+            if (held.load() <= budget_bytes / 2) {
+                break;
+            }
+            Slot& s = *slots[v.second].load();
+            std::lock_guard<std::mutex> lock(s.m);
+            if (!s.buf.empty()) {
+                flush(s);
+            }
+        }
+    }
+
+    // 구간 b의 상태: 처음이면 만들어 끼움 (동시에 만들면 한쪽만 남김)
+    Slot& slot(size_t b) {
+        Slot* s = slots[b].load(std::memory_order_acquire);
+        if (!s) {
+            Slot* fresh = new Slot;
+            if (slots[b].compare_exchange_strong(s, fresh, std::memory_order_acq_rel)) {
+                s = fresh;
+                used++;
+            } else {
+                delete fresh;
+            }
+        }
+        return *s;
+    }
+
+    // 버퍼 메모리를 돌려줌 (구간 잠금을 잡은 상태)
+    void release(Slot& s) {
+        held -= s.buf.capacity();
+        std::vector<uint8_t>().swap(s.buf);
+        s.cap = 0;
+    }
+
+    // 구간 버퍼를 임시 파일 뒤에 붙이고 메모리를 돌려줌 (구간 잠금을 잡은 상태)
+    void flush(Slot& s) {
+        std::lock_guard<std::mutex> lock(spill_m);
+        if (!spill.is_open()) {
+            spill_path = temp_spill_path();
+            spill.open(spill_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+            if (!spill) {
+                throw std::runtime_error("open fail: " + spill_path);
+            }
+        }
+        spill.seekp(static_cast<std::streamoff>(spill_size));
+        spill.write(reinterpret_cast<const char*>(s.buf.data()), static_cast<std::streamsize>(s.buf.size()));
+        if (!spill) {
+            throw std::runtime_error("write fail: " + spill_path);
+        }
+        s.chunks.emplace_back(spill_size, s.buf.size());
+        spill_size += s.buf.size();
+        release(s);
+    }
+
+    template <typename F>
+    void parse(const uint8_t* p, size_t n, F&& f) const {
+        std::vector<uint32_t> ops;
+        for (size_t at = 0; at < n;) {
+            Record rec;
+            memcpy(&rec, p + at, sizeof(Record));
+            at += sizeof(Record);
+            ops.resize(rec.n_ops);
+            if (rec.n_ops) {
+                memcpy(ops.data(), p + at, rec.n_ops * sizeof(uint32_t));
+                at += rec.n_ops * sizeof(uint32_t);
+            }
+            f(static_cast<size_t>(rec.pos), std::string_view(base + rec.read_off, rec.read_len),
+              rec.weight, ops.data(), ops.size());
+        }
+    }
+};
+
+} // namespace bins
+
+#endif // HITBINS_HPP
@@ -0,0 +1,161 @@
+#ifndef KMERTABLE_HPP
+#define KMERTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include "OccTable.hpp"
+#include "Storage.hpp"
+
+namespace kmer {
+
+constexpr size_t MAX_K = 14; // 4^14 * 8 bytes = 2 GiB (2^32 행 초과 시 4 GiB)
+
+// SA 구간 [lo, hi)
+struct Range {
+    uint64_t lo;
+    uint64_t hi;
+};
+
+// 표에 저장하는 구간: 행 수가 2^32 이하이면 32bit, 넘으면 64bit
+template <typename T>
+struct Stored {
+    T lo;
+    T hi;
+};
+
+// 행 수 length를 담으려면 64bit 구간이 필요한지
+inline bool wide_rows(size_t length) {
+    return length > UINT32_MAX;
+}
+
+// 표 한 칸의 바이트
+inline size_t entry_bytes(size_t length) {
+    return wide_rows(length) ? sizeof(Stored<uint64_t>) : sizeof(Stored<uint32_t>);
+}
+
+// 자동 k: 표 크기(4^k * 칸 크기)가 레퍼런스 염기당 2 bytes 이하인 최대 k
+inline size_t auto_k(size_t length) {
+    size_t k = 0;
+    while (k < MAX_K && (size_t(1) << (2 * (k + 1))) * entry_bytes(length) <= 2 * length) {
+        k++;
+    }
+    return k;
+}
+
+// 모든 k-mer의 SA 구간 표: 첫 염기가 최상위 2bit (A=0, C=1, G=2, T=3)
+class KmerTable {
+public:
+    KmerTable() = default;
+
+    // OCC 테이블로 깊이 k까지 후방 탐색하여 구축 (빈 구간은 더 내려가지 않음)
+    void build(size_t k, const occ::OccTable& occ, const std::array<uint64_t, 5>& C,
+               size_t length) {
+        if (k > MAX_K) {
+            throw std::invalid_argument("KmerTable: k must be at most 14");
+        }
+        k_ = k;
+        wide_ = wide_rows(length);
+        narrow.clear();
+        wide.clear();
+        if (k == 0) {
+            return;
+        }
+
+        if (wide_) {
+            wide = search<uint64_t>(k, occ, C, length);
+        } else {
+            narrow = search<uint32_t>(k, occ, C, length);
+        }
+    }
+
+    // 파일 저장 (칸 크기는 인덱스 길이로 정해지므로 따로 기록하지 않음)
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(k_));
+        if (wide_) {
+            w.put_array(wide);
+        } else {
+            w.put_array(narrow);
+        }
+    }
+
+    // 매핑 메모리에서 로드: length = 인덱스 행 수
+    void load(store::Reader& r, size_t length) {
+        k_ = static_cast<size_t>(r.get<uint64_t>());
+        wide_ = wide_rows(length);
+        if (wide_) {
+            r.get_array(wide);
+        } else {
+            r.get_array(narrow);
+        }
+        size_t count = wide_ ? wide.size() : narrow.size();
+        if (k_ > MAX_K || count != (k_ ? size_t(1) << (2 * k_) : 0)) {
+            throw std::runtime_error("KmerTable: invalid table in index file");
+        }
+    }
+
+    // k-mer 키의 SA 구간
+    inline Range operator[](size_t key) const {
+        if (wide_) {
+            return Range{wide[key].lo, wide[key].hi};
+        }
+        return Range{narrow[key].lo, narrow[key].hi};
+    }
+
+    size_t k() const {
+        return k_;
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return narrow.bytes() + wide.bytes();
+    }
+
+private:
+    size_t k_ = 0;                 // k-mer 길이 (0 = 사용 안 함)
+    bool   wide_ = false;          // 행 수가 2^32를 넘어 64bit 구간을 씀
+    store::Array<Stored<uint32_t>> narrow; // 4^k 개 SA 구간 (32bit)
+    store::Array<Stored<uint64_t>> wide;   // 4^k 개 SA 구간 (64bit)
+
+    // 깊이 k까지 후방 탐색하며 칸 크기 T로 구간 기록
+    template <typename T>
+    static std::vector<Stored<T>> search(size_t k, const occ::OccTable& occ,
+                                         const std::array<uint64_t, 5>& C, size_t length) {
+        struct Node {
+            size_t   depth;
+            uint32_t key;   // 지금까지 붙인 접미사의 k-mer 하위 자리
+            size_t   lo, hi;
+        };
+        std::vector<Stored<T>> out(size_t(1) << (2 * k), Stored<T>{0, 0});
+        std::vector<Node> stk;
+        stk.push_back({0, 0, 0, length});
+        while (!stk.empty()) {
+            Node cur = stk.back();
+            stk.pop_back();
+            if (cur.depth == k) {
+                out[cur.key] = Stored<T>{static_cast<T>(cur.lo), static_cast<T>(cur.hi)};
+                continue;
+            }
+            size_t rank_l[5], rank_r[5];
+            occ.rank_all(cur.lo, rank_l);
+            occ.rank_all(cur.hi, rank_r);
+            for (uint32_t c = 0; c < 4; c++) {
+                size_t nl = C[c + 1] + rank_l[c + 1];
+                size_t nr = C[c + 1] + rank_r[c + 1];
+                if (nl >= nr) {
+                    continue;
+                }
+                // 왼쪽에 붙이는 염기가 더 상위 자리
+                uint32_t key = cur.key | (c << (2 * cur.depth));
+                stk.push_back({cur.depth + 1, key, nl, nr});
+            }
+        }
+        return out;
+    }
+};
+
+} // namespace kmer
+
+#endif // KMERTABLE_HPP
@@ -0,0 +1,675 @@
+#ifndef MAPPING_HPP
+#define MAPPING_HPP
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Pipeline.hpp"
+#include "FMIndex.hpp"
+#include "ShardedIndex.hpp"
+#include "Consensus.hpp"
+#include "Align.hpp"
+#include "HitBins.hpp"
+
+using namespace std;
+using namespace chrono;
+
+constexpr size_t QUEUE_DEPTH = 2; // 매퍼 스레드당 큐에 대기할 수 있는 배치 수
+
+// 매핑 결과 배치: (배치 내 리드 번호, 위치)
+// 삽입/삭제 모드에서는 hit마다 cigar[cigar_at[h] .. cigar_at[h + 1])가 정렬 (마지막은 cigar 끝까지)
+struct HitBatch {
+    vector<string_view> reads;
+    vector<pair<size_t, size_t>> hits;
+    vector<uint32_t> cigar;
+    vector<size_t>   cigar_at;
+    vector<uint16_t> weights; // hit별 투표 가중치 (--multi weight, 비어 있으면 모두 1)
+    size_t first = 0;         // 배치 첫 리드의 리드 파일 내 번호
+};
+
+// 리드 하나의 최선 계층 검색 결과 (--strata-file)
+struct ReadStrata {
+    int    best = -1;             // 최선 계층 (mismatch 수), -1 = D 안에 hit 없음
+    size_t hits = 0;              // 최선 계층 hit 수
+    size_t second = 0;            // 다음 계층 hit 수
+    bool   capped = false;        // 최선 계층 hit가 상한 초과 (--max-hits)
+    bool   has_second = false;    // 다음 계층을 검색함 (--second-best, 최선 계층 < D)
+    bool   second_capped = false; // 다음 계층 검색이 상한 초과
+};
+
+// 리드별 최선/다음 계층 hit 수 파일: 매퍼가 배치마다 한 번에 씀
+// 한 줄 = 리드 번호, 최선 계층, 최선 계층 hit 수, 다음 계층 hit 수 ("-" = 없음/검색 안 함, "*" = 상한 초과)
+// 배치 안은 리드 순서, 매퍼가 둘 이상이면 배치끼리는 순서가 섞일 수 있음 (리드 번호로 정렬)
+class StrataLog {
+public:
+    explicit StrataLog(const string& path) : path_(path), ofs(path) {
+        if (!ofs) {
+            throw runtime_error("open fail: " + path);
+        }
+        ofs << "# read\tbest\tbest_hits\tsecond_hits\n";
+    }
+
+    void write(size_t first, const vector<ReadStrata>& rec) {
+        string text;
+        for (size_t i = 0; i < rec.size(); i++) {
+            const ReadStrata& r = rec[i];
+            text += to_string(first + i);
+            text += '\t';
+            text += (r.best < 0) ? "-" : to_string(r.best);
+            text += '\t';
+            text += r.capped ? "*" : to_string(r.hits);
+            text += '\t';
+            text += !r.has_second ? "-" : r.second_capped ? "*" : to_string(r.second);
+            text += '\n';
+        }
+        lock_guard<mutex> lock(mtx);
+        ofs << text;
+        if (!ofs) {
+            throw runtime_error("write fail: " + path_);
+        }
+    }
+
+private:
+    string   path_;
+    ofstream ofs;
+    mutex    mtx;
+};
+
+// 다 쓴 배치를 비움: 용량은 남겨 다음 배치가 할당 없이 채움
+inline void reset(HitBatch& b) {
+    b.reads.clear();
+    b.hits.clear();
+    b.cigar.clear();
+    b.cigar_at.clear();
+    b.weights.clear();
+    b.first = 0;
+}
+
+// 결과 배치의 위치 버퍼 바이트
+inline size_t hit_bytes(const HitBatch& b) {
+    return b.hits.capacity() * sizeof(pair<size_t, size_t>) + b.cigar.capacity() * sizeof(uint32_t)
+         + b.cigar_at.capacity() * sizeof(size_t) + b.weights.capacity() * sizeof(uint16_t);
+}
+
+// 매핑 설정
+struct MapConfig {
+    int        max_err;
+    SearchMode mode;
+    bool       prune;
+    size_t     threads;
+    size_t     batch;
+    string_view reference; // 예측 위치 확인용 레퍼런스
+    bool       anchor;     // 앞 리드 위치로 예측한 위치를 먼저 확인
+    bool       exhaustive; // 예측 위치가 맞아도 전체 검색
+    bool       indels;     // max_err를 편집 거리로 보고 시드 + 정렬로 매핑
+    bool       best;       // 허용 mismatch를 0부터 늘려 최선 계층에서 멈춤
+    bool       second_best; // 최선 계층 다음 계층의 hit 수도 셈
+    size_t     max_hits;   // 리드당 hit 상한 (SIZE_MAX = 제한 없음)
+    int        multi;      // 다중 매핑 리드 투표 방식 (opt::MULTI_*)
+    bool       fused;      // 매퍼가 위치를 모으지 않고 바로 투표 (투표 단계 없음)
+    StrataLog* strata = nullptr; // 리드별 계층 기록 (--strata-file, 없으면 기록 안 함)
+};
+
+constexpr uint16_t UNIQUE_WEIGHT = 4; // --multi weight: 유일 매핑 리드의 표 수, 위치 c개면 위치당 4 / c
+
+constexpr size_t MAX_STRATA = 8; // 최선 계층 분포 칸 수 (마지막 칸은 그 이상 전부)
+
+// 파이프라인 단계별 시간
+struct PipelineTimes {
+    stream::StageTime parse;
+    stream::StageTime map;
+    stream::StageTime vote;
+    long long wall_ms = 0;
+    size_t read_cnt = 0;
+    atomic<size_t> nodes{0}; // 검색 중 확장한 노드 수
+    atomic<size_t> anchor_reads{0}; // 예측 위치를 적용한 (빈 리드가 아닌) 리드 수
+    atomic<size_t> anchor_hits{0};  // 예측 위치에서 확인된 리드 수
+    atomic<size_t> anchor_short{0}; // 전체 검색에 예측 위치 외의 위치도 있던 리드 수 (--exhaustive)
+    atomic<size_t> indel_mapped{0};   // 정렬이 하나 이상 나온 리드 수 (--indels)
+    atomic<size_t> indel_aligned{0};  // 정렬로 확인한 후보 구간 수
+    atomic<size_t> indel_gapped{0};   // 삽입/삭제가 들어간 정렬 수
+    atomic<size_t> capped{0};         // hit 상한을 넘어 투표에서 뺀 리드 수 (--max-hits)
+    atomic<size_t> strata[MAX_STRATA] = {}; // 최선 계층(mismatch 수)별 리드 수 (--best)
+    atomic<size_t> best_unique{0};    // 최선 계층 hit가 하나인 리드 수
+    atomic<size_t> best_multi{0};     // 최선 계층 hit가 둘 이상인 리드 수
+    atomic<size_t> second_none{0};    // 최선 hit가 하나이고 다음 계층 hit도 없는 리드 수 (--second-best)
+    atomic<size_t> second_some{0};    // 다음 계층 hit가 있는 리드 수
+    atomic<size_t> hit_rows{0};       // 검색된 위치 수 (SA 구간 크기 합)
+    atomic<size_t> hit_resolved{0};   // SA 조회로 복원한 위치 수
+    atomic<size_t> multi_reads{0};    // 위치가 둘 이상인 리드 수
+    atomic<size_t> multi_skipped{0};  // 위치를 복원하지 않고 투표에서 뺀 다중 매핑 리드 수
+    atomic<size_t> search_peak{0};    // 매퍼 하나의 검색 결과 버퍼 최대 바이트
+    atomic<size_t> flight_bytes{0};   // 매핑이 끝나고 투표 전인 배치의 위치 버퍼 바이트
+    atomic<size_t> flight_peak{0};    // 그 최댓값
+};
+
+// 최댓값 갱신
+inline void update_peak(atomic<size_t>& peak, size_t v) {
+    size_t cur = peak.load();
+    while (v > cur && !peak.compare_exchange_weak(cur, v)) {
+    }
+}
+
+// 배치 하나의 위치 통계 (배치 끝에 PipelineTimes로 합침)
+struct HitStats {
+    size_t rows = 0, resolved = 0, multi = 0, skipped = 0;
+
+    void flush(PipelineTimes& times) const {
+        times.hit_rows      += rows;
+        times.hit_resolved  += resolved;
+        times.multi_reads   += multi;
+        times.multi_skipped += skipped;
+    }
+};
+
+// 리드 하나의 검색 결과를 위치마다 sink(pos, weight)로 넘기고 위치 수 반환
+// 구간 모드는 위치 수를 SA 조회 없이 알므로 투표하지 않을 리드(--multi skip|weight)는 위치를 복원하지 않음
+template <typename Index, typename Sink>
+inline size_t emit_hits(const Index& fm, const MapConfig& mc, const SearchContext& ctx,
+                        HitStats& st, Sink&& sink) {
+    size_t cnt = ctx.rows;
+    st.rows  += cnt;
+    st.multi += (cnt > 1);
+    if (cnt == 0) {
+        return 0;
+    }
+    uint16_t weight = 1;
+    if (mc.multi == opt::MULTI_SKIP) {
+        weight = (cnt == 1);
+    } else if (mc.multi == opt::MULTI_WEIGHT) {
+        weight = (cnt <= UNIQUE_WEIGHT) ? static_cast<uint16_t>(UNIQUE_WEIGHT / cnt) : 0;
+    }
+    if (weight == 0) {
+        st.skipped++;
+        return cnt;
+    }
+    fm.for_each_hit(ctx, [&](size_t pos) { sink(pos, weight); });
+    st.resolved += cnt;
+    return cnt;
+}
+
+constexpr size_t VOTE_STRIPE_BITS = 16; // fused 투표 잠금 단위: 레퍼런스 65536 위치
+
+// 여러 매퍼가 같은 투표 표에 쓸 때의 잠금: 레퍼런스 구간마다 mutex 하나
+// 리드 하나가 걸치는 구간(보통 하나)만 잠그므로 염기마다 원자 연산하는 것보다 훨씬 쌈
+class VoteLocks {
+public:
+    explicit VoteLocks(size_t ref_len)
+        : count((ref_len >> VOTE_STRIPE_BITS) + 1), locks(new mutex[count]) {}
+
+    // 레퍼런스 [lo, hi) 구간을 잠근 채 f() 실행 (작은 구간부터 잠가 교착 없음)
+    template <typename F>
+    void with(size_t lo, size_t hi, F&& f) {
+        size_t a = lo >> VOTE_STRIPE_BITS;
+        size_t b = (max(hi, lo + 1) - 1) >> VOTE_STRIPE_BITS;
+        for (size_t k = a; k <= b; k++) {
+            locks[k].lock();
+        }
+        f();
+        for (size_t k = a; k <= b; k++) {
+            locks[k].unlock();
+        }
+    }
+
+private:
+    size_t count;
+    unique_ptr<mutex[]> locks;
+};
+
+// 투표 대상이 스스로 잠그는지: 투표 표는 VoteLocks가 필요하고 구간 기록은 내부에서 구간별로 잠금
+inline bool self_locking(const consensus::VoteTable&) { return false; }
+inline bool self_locking(const bins::HitBins&) { return true; }
+
+// 리드 하나를 pos부터 투표 (레퍼런스 범위를 벗어나면 건너뜀)
+// locks가 있으면 여러 매퍼가 같은 표에 동시에 투표하므로 리드가 걸치는 구간을 잠금
+// Votes = consensus::VoteTable (바로 투표) 또는 bins::HitBins (위치 구간별로 기록해 두었다가 창 단위 투표)
+template <typename Votes>
+inline void vote_read(Votes& votes, size_t ref_len, size_t pos, string_view read,
+                      uint16_t weight, VoteLocks* locks) {
+    if (pos + read.size() > ref_len) {
+        return;
+    }
+    if (locks) {
+        locks->with(pos, pos + read.size(), [&]() { votes.add_read(pos, read, weight); });
+    } else {
+        votes.add_read(pos, read, weight);
+    }
+}
+
+// 결과 배치 하나를 투표
+template <typename Votes>
+inline void vote_batch(Votes& votes, size_t ref_len, const HitBatch& in, VoteLocks* locks) {
+    for (size_t h = 0; h < in.hits.size(); h++) {
+        const auto& hit = in.hits[h];
+        const auto& read = in.reads[hit.first];
+        if (!in.cigar_at.empty()) {
+            // 정렬된 hit: CIGAR를 따라 투표
+            size_t from = in.cigar_at[h];
+            size_t to = (h + 1 < in.hits.size()) ? in.cigar_at[h + 1] : in.cigar.size();
+            const uint32_t* ops = in.cigar.data() + from;
+            size_t span = align::ref_span(ops, to - from);
+            if (hit.second + span > ref_len) {
+                continue;
+            }
+            if (locks) {
+                locks->with(hit.second, hit.second + span,
+                            [&]() { votes.add_alignment(hit.second, read, ops, to - from); });
+            } else {
+                votes.add_alignment(hit.second, read, ops, to - from);
+            }
+            continue;
+        }
+        vote_read(votes, ref_len, hit.second, read, in.weights.empty() ? 1 : in.weights[h], locks);
+    }
+}
+
+constexpr size_t SEED_MAX_HITS = 1000; // 이보다 많이 나오는 (반복 서열) 시드는 후보에서 제외
+
+// 삽입/삭제 모드 작업 공간: 매퍼 스레드마다 하나
+struct IndelContext {
+    SearchContext      seed;  // 시드 정확 검색
+    align::Aligner     aligner;
+    vector<long long>  cands; // 후보 시작 위치 (시드 위치 - 리드 내 오프셋)
+};
+
+// 삽입/삭제 허용 매핑: 편집 거리 D 이하면 리드를 D+1개 조각으로 나눈 것 중 하나는
+// 정확히 일치하므로 (비둘기집) 조각을 정확 검색하여 후보 위치를 얻고, 가까운 후보끼리
+// 묶은 구간마다 비트 병렬 편집 거리로 확인한 뒤 밴드 DP로 시작 위치와 CIGAR를 구함
+template <typename Index>
+inline void map_indels(const Index& fm, const MapConfig& mc, HitBatch& out,
+                       IndelContext& ictx, PipelineTimes& times) {
+    const long long D = mc.max_err;
+    const long long ref_len = static_cast<long long>(mc.reference.size());
+    size_t mapped = 0, aligned = 0, gapped = 0;
+    ictx.seed.max_hits = SEED_MAX_HITS; // 반복 서열 시드는 위치를 다 찾기 전에 검색 중단
+    for (size_t i = 0; i < out.reads.size(); i++) {
+        string_view read = out.reads[i];
+        if (read.empty()) {
+            continue;
+        }
+        long long m = static_cast<long long>(read.size());
+        long long parts = min<long long>(D + 1, m);
+        long long seg = m / parts;
+
+        auto& cands = ictx.cands;
+        cands.clear();
+        for (long long s = 0; s < parts; s++) {
+            long long off = s * seg;
+            long long len = (s + 1 == parts) ? m - off : seg;
+            const auto& hits = fm.locate(read.substr(off, len), 0, ictx.seed);
+            if (ictx.seed.capped) {
+                continue;
+            }
+            for (size_t pos : hits) {
+                cands.push_back(static_cast<long long>(pos) - off);
+            }
+        }
+        sort(cands.begin(), cands.end());
+
+        // 시작 위치 차이가 D 이하인 후보는 같은 위치 (삽입/삭제로 밀린 것)
+        size_t before = out.hits.size();
+        for (size_t a = 0; a < cands.size();) {
+            size_t b = a + 1;
+            while (b < cands.size() && cands[b] - cands[b - 1] <= D) {
+                b++;
+            }
+            long long lo = max(0LL, cands[a] - D);
+            long long hi = min(ref_len, cands[b - 1] + m + D);
+            long long expect = min(hi - 1, max(lo, cands[a] + m - 1));
+            a = b;
+            if (lo >= hi) {
+                continue;
+            }
+            aligned++;
+            size_t end = 0;
+            int dist = 0;
+            if (!ictx.aligner.best_end(read, mc.reference, lo, hi, expect, mc.max_err, end, dist)) {
+                continue;
+            }
+            size_t at = out.cigar.size();
+            size_t pos = ictx.aligner.traceback(read, mc.reference, lo, end, dist, mc.max_err, out.cigar);
+            // 이웃 구간이 같은 정렬을 찾은 경우
+            if (out.hits.size() > before && out.hits.back().second == pos) {
+                out.cigar.resize(at);
+                continue;
+            }
+            gapped += (out.cigar.size() - at != 1);
+            out.hits.emplace_back(i, pos);
+            out.cigar_at.push_back(at);
+        }
+        mapped += (out.hits.size() > before);
+    }
+    times.indel_mapped  += mapped;
+    times.indel_aligned += aligned;
+    times.indel_gapped  += gapped;
+}
+
+// 최선 계층 우선 매핑: 리드마다 허용 mismatch 0, 1, ..., max_err 순으로 검색하여
+// hit가 처음 나온 계층에서 멈춤. 대부분의 리드는 0에서 끝나므로 큰 D의 이웃은 거의 탐색하지 않음
+// second_best이면 최선 계층 d에서 끝난 리드를 d+1로 한 번 더 검색하여 다음 계층 hit 수를 셈
+// emit(배치 내 리드 번호, 검색 결과)로 결과를 넘기고, mc.strata가 있으면 리드별 계층을 rec에 기록
+template <typename Index, typename Emit>
+inline void map_best(const Index& fm, const MapConfig& mc, const HitBatch& out, SearchContext& ctx,
+                     PipelineTimes& times, vector<ReadStrata>& rec, Emit&& emit) {
+    const bool log = mc.strata != nullptr;
+    if (log) {
+        rec.assign(out.reads.size(), ReadStrata());
+    }
+    size_t strata[MAX_STRATA] = {};
+    size_t unique = 0, multi = 0, capped = 0, second_none = 0, second_some = 0;
+    for (size_t i = 0; i < out.reads.size(); i++) {
+        string_view read = out.reads[i];
+        if (read.empty()) {
+            continue;
+        }
+        for (int d = 0; d <= mc.max_err; d++) {
+            fm.locate(read, d, ctx);
+            if (ctx.capped) {
+                capped++;
+                if (log) {
+                    rec[i].best = d;
+                    rec[i].capped = true;
+                }
+                break;
+            }
+            if (ctx.rows == 0) {
+                continue;
+            }
+            size_t best_cnt = ctx.rows;
+            if (log) {
+                rec[i].best = d;
+                rec[i].hits = best_cnt;
+            }
+            emit(i, ctx);
+            strata[min<size_t>(d, MAX_STRATA - 1)]++;
+            (best_cnt == 1 ? unique : multi)++;
+
+            // 다음 계층: d+1 위치 수에서 최선 계층 위치 수를 뺀 수 (셈만 하므로 SA 조회 없음,
+            // 상한 초과는 hit 있음으로 셈)
+            if (mc.second_best && d < mc.max_err) {
+                bool keep_mode = ctx.intervals_only;
+                ctx.intervals_only = true;
+                fm.locate(read, d + 1, ctx);
+                ctx.intervals_only = keep_mode;
+                bool some = ctx.capped || ctx.rows > best_cnt;
+                second_some += some;
+                second_none += (!some && best_cnt == 1);
+                if (log) {
+                    rec[i].has_second = true;
+                    rec[i].second_capped = ctx.capped;
+                    rec[i].second = ctx.capped ? 0 : ctx.rows - best_cnt;
+                }
+            }
+            break;
+        }
+    }
+    for (size_t d = 0; d < MAX_STRATA; d++) {
+        times.strata[d] += strata[d];
+    }
+    times.best_unique += unique;
+    times.best_multi  += multi;
+    times.capped      += capped;
+    times.second_none += second_none;
+    times.second_some += second_some;
+}
+
+// 예측 위치 우선 매핑: 리드가 위치 순서대로 이어져 있으면 앞 리드가 유일하게 매핑된
+// 위치 + 길이가 다음 리드 위치이므로 Hamming 거리로 먼저 확인하고, 실패하거나 앞 리드
+// 위치가 모호하면 locate로 검색. exhaustive이면 확인 여부와 관계없이 검색하여 결과 동일
+template <typename Index>
+inline void map_anchored(const Index& fm, const MapConfig& mc, HitBatch& out,
+                         SearchContext& ctx, PipelineTimes& times) {
+    size_t reads = 0, fast_cnt = 0, short_cnt = 0;
+    bool   has_pred = false;
+    size_t pred = 0;
+    for (size_t i = 0; i < out.reads.size(); i++) {
+        string_view read = out.reads[i];
+        if (read.empty()) {
+            continue;
+        }
+        reads++;
+        bool fast = has_pred && pred + read.size() <= mc.reference.size()
+                    && code::hamming_within(read.data(), mc.reference.data() + pred,
+                                            read.size(), mc.max_err);
+        size_t unique_hit = 0, hit_cnt = 0;
+        if (fast && !mc.exhaustive) {
+            out.hits.emplace_back(i, pred);
+        } else {
+            const auto& hits = fm.locate(read, mc.max_err, ctx);
+            for (size_t pos : hits) {
+                out.hits.emplace_back(i, pos);
+            }
+            hit_cnt = hits.size();
+            times.capped += ctx.capped;
+            unique_hit = hit_cnt ? hits[0] : 0;
+            short_cnt += (fast && hit_cnt > 1);
+        }
+        fast_cnt += fast;
+
+        // 다음 리드 예측 위치: 매핑되지 않은 리드(mismatch 초과)도 자기 자리를 차지한다고 보고 건너뜀
+        if (fast || (hit_cnt == 0 && has_pred)) {
+            pred += read.size();
+        } else if (hit_cnt == 1) {
+            pred = unique_hit + read.size();
+            has_pred = true;
+        } else {
+            has_pred = false;
+        }
+    }
+    times.anchor_reads += reads;
+    times.anchor_hits  += fast_cnt;
+    times.anchor_short += short_cnt;
+}
+
+// 스트리밍 파이프라인: 파서 -> 매퍼 스레드 -> 투표
+// 각 큐 용량이 고정되어 있어 메모리는 입력 크기가 아닌 배치 크기에 비례
+// Index = FMIndex 또는 ShardedIndex (검색 인터페이스가 같음)
+template <typename Index, typename Votes>
+inline void run_pipeline(const Index& fm, const io::MappedFile& file, const MapConfig& mc,
+                         Votes& votes, size_t ref_len, PipelineTimes& times) {
+    const int    max_err  = mc.max_err;
+    const size_t threads  = mc.threads;
+    const size_t batch    = mc.batch;
+    // fused: 매퍼가 동시에 투표하므로 스레드가 둘 이상이면 구간 잠금
+    unique_ptr<VoteLocks> vote_locks;
+    if (mc.fused && threads > 1 && !self_locking(votes)) {
+        vote_locks = make_unique<VoteLocks>(ref_len);
+    }
+    VoteLocks* const shared = vote_locks.get();
+    stream::BoundedQueue<HitBatch> read_q(threads * QUEUE_DEPTH);
+    stream::BoundedQueue<HitBatch> hit_q(threads * QUEUE_DEPTH);
+    // 다 쓴 배치를 파서에 돌려주는 큐: 동시에 살아 있을 수 있는 배치 수
+    // (두 큐 + 매퍼마다 하나 + 파서 + 투표)만큼 미리 넣어 두어 데운 뒤에는 배치를 새로 만들지 않음
+    stream::BoundedQueue<HitBatch> spare_q(2 * threads * QUEUE_DEPTH + threads + 2);
+    for (size_t i = 0; i < 2 * threads * QUEUE_DEPTH + threads + 2; i++) {
+        spare_q.push(HitBatch());
+    }
+    auto recycle = [&](HitBatch& b) {
+        reset(b);
+        spare_q.try_push(b);
+    };
+
+    exception_ptr error;
+    mutex error_mtx;
+    auto fail = [&]() {
+        lock_guard<mutex> lock(error_mtx);
+        if (!error) {
+            error = current_exception();
+        }
+        read_q.close();
+        hit_q.close();
+    };
+
+    auto t_start = high_resolution_clock::now();
+
+    // 파서: 매핑된 파일을 배치로 분리 (배치 첫 리드 번호 기록)
+    thread parser([&]() {
+        try {
+            stream::StageClock clock(times.parse);
+            io::ReadScanner scanner(file.data(), file.size());
+            HitBatch next;
+            spare_q.try_pop(next);
+            while (scanner.next(next.reads, batch)) {
+                next.first = times.read_cnt;
+                times.read_cnt += next.reads.size();
+                clock.busy();
+                if (!read_q.push(std::move(next))) {
+                    break;
+                }
+                clock.idle();
+                if (!spare_q.try_pop(next)) {
+                    next = HitBatch();
+                }
+            }
+            read_q.close();
+        } catch (...) {
+            fail();
+        }
+    });
+
+    // 매퍼: 배치 단위로 가져가므로 오래 걸리는 리드가 다른 스레드를 막지 않음
+    atomic<size_t> active{threads};
+    vector<thread> mappers;
+    mappers.reserve(threads);
+    for (size_t t = 0; t < threads; t++) {
+        mappers.emplace_back([&]() {
+            try {
+                stream::StageClock clock(times.map);
+                SearchContext ctx;
+                ctx.mode = mc.mode;
+                ctx.prune = mc.prune;
+                ctx.max_hits = mc.max_hits;
+                // fused이면 위치를 SA 구간에서 바로 투표하므로 위치 배열도 만들지 않음 (예측 경로는 위치 필요)
+                ctx.intervals_only = !mc.anchor && (mc.multi != opt::MULTI_ALL || mc.fused);
+                IndelContext ictx;
+                vector<ReadStrata> rec; // 배치의 리드별 계층 (--strata-file)
+                HitBatch out;
+                while (read_q.pop(out)) {
+                    clock.idle();
+                    HitStats st;
+                    // 검색 결과 전달: fused이면 위치를 모으지 않고 바로 투표
+                    auto emit = [&](size_t id, const SearchContext& ctx) {
+                        if (mc.fused) {
+                            string_view read = out.reads[id];
+                            emit_hits(fm, mc, ctx, st, [&](size_t pos, uint16_t w) {
+                                vote_read(votes, ref_len, pos, read, w, shared);
+                            });
+                        } else {
+                            emit_hits(fm, mc, ctx, st, [&](size_t pos, uint16_t w) {
+                                out.hits.emplace_back(id, pos);
+                                if (mc.multi == opt::MULTI_WEIGHT) {
+                                    out.weights.push_back(w);
+                                }
+                            });
+                        }
+                    };
+                    if (mc.indels) {
+                        map_indels(fm, mc, out, ictx, times);
+                    } else if (mc.anchor) {
+                        map_anchored(fm, mc, out, ctx, times);
+                    } else if (mc.best) {
+                        map_best(fm, mc, out, ctx, times, rec, emit);
+                        st.flush(times);
+                        if (mc.strata) {
+                            mc.strata->write(out.first, rec);
+                        }
+                    } else {
+                        for (size_t i = 0; i < out.reads.size(); i++) {
+                            // 빈 리드는 모든 위치에 매칭되지만 투표에 기여하지 않으므로 건너뜀
+                            if (out.reads[i].empty()) {
+                                continue;
+                            }
+                            fm.locate(out.reads[i], max_err, ctx);
+                            times.capped += ctx.capped;
+                            emit(i, ctx);
+                        }
+                        st.flush(times);
+                    }
+                    // 위치 버퍼 메모리: 검색 작업 공간, 투표 전 배치
+                    size_t search_bytes = ctx.hits.capacity() * sizeof(size_t)
+                                        + ctx.intervals.capacity() * sizeof(pair<size_t, size_t>);
+                    update_peak(times.search_peak, search_bytes);
+                    if (mc.fused) {
+                        // 정렬/예측 위치 경로의 배치는 매퍼에서 바로 투표하고 파서에 돌려줌
+                        vote_batch(votes, ref_len, out, shared);
+                        recycle(out);
+                        clock.busy();
+                        continue;
+                    }
+                    update_peak(times.flight_peak, times.flight_bytes += hit_bytes(out));
+                    clock.busy();
+                    if (!hit_q.push(std::move(out))) {
+                        break;
+                    }
+                    clock.idle();
+                }
+                times.nodes += ctx.nodes + ictx.seed.nodes;
+            } catch (...) {
+                fail();
+            }
+            if (--active == 0) {
+                hit_q.close();
+            }
+        });
+    }
+
+    // 투표: 도착하는 순서대로 반영 (덧셈이므로 순서와 무관하게 결과 동일), fused이면 매퍼가 이미 투표
+    // 구간 기록(HitBins)은 쓰기 실패로 던질 수 있으므로 다른 단계처럼 큐를 닫고 join 뒤에 다시 던짐
+    try {
+        stream::StageClock clock(times.vote);
+        HitBatch in;
+        while (hit_q.pop(in)) {
+            clock.idle();
+            vote_batch(votes, ref_len, in, nullptr);
+            times.flight_bytes -= hit_bytes(in);
+            recycle(in);
+            clock.busy();
+        }
+    } catch (...) {
+        fail();
+    }
+
+    parser.join();
+    for (auto& th : mappers) {
+        th.join();
+    }
+    auto t_end = high_resolution_clock::now();
+    times.wall_ms = duration_cast<milliseconds>(t_end - t_start).count();
+
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+// 구간 기록을 위치 순서로 재생하여 창 하나 크기의 투표 표로 컨센서스를 만들고, 확정된 구간부터 out에 씀
+// 구간 b의 기록은 [b*W, (b+1)*W + 최대 span)에만 투표하므로 창 = W + 최대 span이면 충분
+// 반환: 창 투표 표 메모리 (바이트)
+inline size_t call_windowed(bins::HitBins& hb, size_t ref_len, size_t window, ostream& out) {
+    consensus::VoteTable win(window + hb.max_span());
+    for (size_t b = 0, base = 0; base < ref_len; b++, base += window) {
+        hb.replay(b, [&](size_t pos, string_view read, uint16_t weight, const uint32_t* ops, size_t n_ops) {
+            if (n_ops) {
+                win.add_alignment(pos - base, read, ops, n_ops);
+            } else {
+                win.add_read(pos - base, read, weight);
+            }
+        });
+        size_t done = min(window, ref_len - base);
+        out << win.call(0, done);
+        win.shift(done);
+    }
+    return win.bytes();
+}
+
+#endif // MAPPING_HPP
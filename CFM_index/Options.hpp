@@ -0,0 +1,195 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "Parallel.hpp"
+
+using namespace std;
+
+namespace opt {
+
+constexpr size_t KMER_AUTO = static_cast<size_t>(-1); // 레퍼런스 길이로 k 결정
+
+// 다중 매핑 리드 투표 방식 (--multi)
+constexpr int MULTI_ALL    = 0; // 모든 위치에 투표
+constexpr int MULTI_SKIP   = 1; // 위치가 둘 이상이면 투표 안 함
+constexpr int MULTI_WEIGHT = 2; // 위치 수에 반비례하는 가중치로 투표
+
+// 실행 옵션
+struct Options {
+    size_t sa_rate = 1;   // SA 샘플링 간격 (--sa-rate)
+    bool sa_bench = false; // 간격별 SA 메모리와 리드당 검색 시간 측정 (--sa-bench)
+    string index_path;    // 저장된 인덱스 파일 (--index)
+    size_t threads = par::default_threads(); // 매핑 스레드 수 (--threads)
+    bool scaling = false; // 1, 2, 4, ... 스레드 매핑 시간 측정 (--scaling)
+    size_t batch = 4096;  // 파이프라인 배치당 리드 수 (--batch)
+    bool scheme = false;  // 양방향 인덱스 검색 스킴 사용 (--search scheme)
+    size_t kmer = KMER_AUTO; // k-mer 구간 표 길이, 0 = 사용 안 함 (--kmer)
+    bool kmer_bench = false; // k별 리드당 검색 시간 측정 (--kmer-bench)
+    bool prune = false;   // 하한 배열 가지치기 (--prune)
+    bool prune_bench = false; // 가지치기 전후 노드 수, 검색 시간 비교 (--prune-bench)
+    bool anchor = false;  // 앞 리드의 유일 위치로 다음 리드 위치를 예측하여 먼저 확인 (--anchor)
+    bool exhaustive = false; // 예측 위치를 확인한 뒤에도 전체 검색, 결과는 기본 검색과 동일 (--exhaustive)
+    bool indels = false;  // D를 편집 거리(치환 + 삽입/삭제)로 보고 매핑 (--indels)
+    bool best = false;    // 허용 mismatch 0, 1, ..., D 순으로 검색하여 hit가 처음 나온 계층에서 멈춤 (--best)
+    bool second_best = false; // 최선 계층 다음 계층의 hit 수도 셈 (--second-best)
+    string strata_path;   // 리드별 최선/다음 계층 hit 수 파일 (--strata-file)
+    size_t max_hits = 0;  // 리드당 hit 상한, 넘으면 반복 서열로 보고 투표 제외, 0 = 제한 없음 (--max-hits)
+    int multi = MULTI_ALL; // 다중 매핑 리드 투표 방식 (--multi all|skip|weight)
+    bool fused = false;   // 매퍼가 위치를 모으지 않고 바로 투표 (--fused)
+    size_t shards = 1;    // 레퍼런스를 겹치는 샤드로 나누어 샤드마다 인덱스, 1 = 단일 인덱스 (--shards)
+    size_t shard_overlap = 1024; // 이웃 샤드가 겹치는 염기 수, 리드 길이 상한 (--shard-overlap)
+    size_t shard_threads = 0; // 검색 하나에서 샤드를 동시에 검색할 스레드 수, 0 = 하드웨어 스레드 / 매핑 스레드 (--shard-threads)
+    size_t window = 0;    // 컨센서스 창 크기, hit를 위치 구간별로 기록해 창 단위로 투표, 0 = 전체 투표 표 (--window)
+    size_t bin_memory = 8; // 창 모드에서 메모리에 둘 구간 기록 합 상한 MiB, 넘으면 임시 파일로 (--bin-memory)
+    vector<string> given; // 명령행에 준 옵션 이름
+};
+
+// 정수 옵션 값 파싱
+inline size_t parse_size(const string& name, const string& value) {
+    size_t used = 0;
+    unsigned long long v = 0;
+    try {
+        v = stoull(value, &used);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != value.size() || value.empty() || value[0] == '-') {
+        throw invalid_argument("invalid value for " + name + ": " + value);
+    }
+    return static_cast<size_t>(v);
+}
+
+// 명령행 옵션 파싱
+inline Options parse_options(int argc, char* argv[]) {
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) {
+                throw invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--sa-rate") {
+            opts.sa_rate = parse_size(arg, value());
+            if (opts.sa_rate == 0) {
+                throw invalid_argument("--sa-rate must be positive");
+            }
+        } else if (arg == "--threads") {
+            opts.threads = parse_size(arg, value());
+            if (opts.threads == 0) {
+                throw invalid_argument("--threads must be positive");
+            }
+        } else if (arg == "--batch") {
+            opts.batch = parse_size(arg, value());
+            if (opts.batch == 0) {
+                throw invalid_argument("--batch must be positive");
+            }
+        } else if (arg == "--kmer") {
+            string v = value();
+            opts.kmer = (v == "auto") ? KMER_AUTO : parse_size(arg, v);
+            if (opts.kmer != KMER_AUTO && opts.kmer > 14) {
+                throw invalid_argument("--kmer must be at most 14");
+            }
+        } else if (arg == "--sa-bench") {
+            opts.sa_bench = true;
+        } else if (arg == "--kmer-bench") {
+            opts.kmer_bench = true;
+        } else if (arg == "--prune") {
+            opts.prune = true;
+        } else if (arg == "--prune-bench") {
+            opts.prune = true;
+            opts.prune_bench = true;
+        } else if (arg == "--anchor") {
+            opts.anchor = true;
+        } else if (arg == "--exhaustive") {
+            opts.anchor = true;
+            opts.exhaustive = true;
+        } else if (arg == "--indels") {
+            opts.indels = true;
+        } else if (arg == "--best") {
+            opts.best = true;
+        } else if (arg == "--second-best") {
+            opts.best = true;
+            opts.second_best = true;
+        } else if (arg == "--strata-file") {
+            opts.best = true;
+            opts.strata_path = value();
+        } else if (arg == "--multi") {
+            string mode = value();
+            if (mode == "all") {
+                opts.multi = MULTI_ALL;
+            } else if (mode == "skip") {
+                opts.multi = MULTI_SKIP;
+            } else if (mode == "weight") {
+                opts.multi = MULTI_WEIGHT;
+            } else {
+                throw invalid_argument("invalid value for --multi: " + mode);
+            }
+        } else if (arg == "--fused") {
+            opts.fused = true;
+        } else if (arg == "--shards") {
+            opts.shards = parse_size(arg, value());
+            if (opts.shards == 0) {
+                throw invalid_argument("--shards must be positive");
+            }
+        } else if (arg == "--shard-overlap") {
+            opts.shard_overlap = parse_size(arg, value());
+        } else if (arg == "--shard-threads") {
+            opts.shard_threads = parse_size(arg, value());
+        } else if (arg == "--window") {
+            opts.window = parse_size(arg, value());
+            if (opts.window == 0) {
+                throw invalid_argument("--window must be positive");
+            }
+        } else if (arg == "--bin-memory") {
+            opts.bin_memory = parse_size(arg, value());
+            if (opts.bin_memory == 0) {
+                throw invalid_argument("--bin-memory must be positive");
+            }
+        } else if (arg == "--max-hits") {
+            opts.max_hits = parse_size(arg, value());
+            if (opts.max_hits == 0) {
+                throw invalid_argument("--max-hits must be positive");
+            }
+        } else if (arg == "--scaling") {
+            opts.scaling = true;
+        } else if (arg == "--search") {
+            string mode = value();
+            if (mode != "backtrack" && mode != "scheme") {
+                throw invalid_argument("invalid value for --search: " + mode);
+            }
+            opts.scheme = (mode == "scheme");
+        } else if (arg == "--index") {
+            opts.index_path = value();
+        } else {
+            throw invalid_argument("unknown option: " + arg);
+        }
+        opts.given.push_back(arg);
+    }
+    return opts;
+}
+
+// 옵션을 명령행에서 주었는지
+inline bool given(const Options& opts, const string& name) {
+    return find(opts.given.begin(), opts.given.end(), name) != opts.given.end();
+}
+
+// used에 없는 옵션을 주었으면 거부: 이 실행 파일에서 효과가 없는 옵션을 조용히 무시하지 않음
+inline void reject_unused(const Options& opts, const vector<string>& used, const string& tool) {
+    for (const auto& name : opts.given) {
+        if (find(used.begin(), used.end(), name) == used.end()) {
+            throw invalid_argument(name + " has no effect on " + tool);
+        }
+    }
+}
+
+} // namespace opt
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,214 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+
+namespace par {
+
+// 기본 스레드 수
+inline size_t default_threads() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+// 동적 스케줄링 병렬 루프: 각 스레드가 chunk 단위로 다음 구간을 가져감
+// fn(i, tid) 는 i 마다 한 번 호출되며 tid 는 0 ~ threads-1
+template <typename Fn>
+void parallel_for(size_t n, size_t threads, size_t chunk, Fn&& fn) {
+    if (chunk == 0) {
+        chunk = 1;
+    }
+    threads = std::max<size_t>(1, std::min(threads, (n + chunk - 1) / chunk));
+    if (threads == 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mtx;
+
+    auto worker = [&](size_t tid) {
+        try {
+            while (true) {
+                size_t begin = next.fetch_add(chunk);
+                if (begin >= n) {
+                    break;
+                }
+                size_t end = std::min(n, begin + chunk);
+                for (size_t i = begin; i < end; i++) {
+                    fn(i, tid);
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mtx);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(n); // 나머지 작업 중단
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// 상주 작업자 스레드 묶음: run(n, fn)마다 스레드를 새로 만들지 않고 대기 중인 작업자가 fn(i)를 나눠 실행
+// 호출 스레드도 자기 작업을 함께 처리하고, 여러 스레드가 동시에 run을 불러도 됨
+// 작업은 호출자 스택에 두고 목록으로 이어 붙이므로 run은 할당하지 않음
+class TaskPool {
+public:
+    explicit TaskPool(size_t workers) {
+        threads_.reserve(workers);
+        for (size_t t = 0; t < workers; t++) {
+            threads_.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& th : threads_) {
+            th.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t workers() const {
+        return threads_.size();
+    }
+
+    // fn(i)를 i = 0 ~ n-1 마다 한 번 실행하고 모두 끝나면 반환 (처음 난 예외를 다시 던짐)
+    template <typename Fn>
+    void run(size_t n, Fn&& fn) {
+        using F = std::remove_reference_t<Fn>;
+        if (threads_.empty() || n <= 1) {
+            for (size_t i = 0; i < n; i++) {
+                fn(i);
+            }
+            return;
+        }
+        Job job;
+        job.call = [](void* f, size_t i) { (*static_cast<F*>(f))(i); };
+        job.fn = const_cast<void*>(static_cast<const void*>(&fn));
+        job.n = n;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Job** tail = &head_;
+            while (*tail) {
+                tail = &(*tail)->link;
+            }
+            *tail = &job;
+        }
+        work_cv_.notify_all();
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        size_t i = 0;
+        while (take(job, i)) {
+            execute(job, i, lock);
+        }
+        done_cv_.wait(lock, [&]() { return job.done == job.n; });
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+private:
+    struct Job {
+        void (*call)(void*, size_t) = nullptr;
+        void* fn = nullptr;
+        size_t n = 0;
+        size_t next = 0;         // 다음에 가져갈 번호
+        size_t done = 0;         // 끝난 번호 수
+        Job* link = nullptr;     // 대기 목록의 다음 작업
+        std::exception_ptr error;
+    };
+
+    std::vector<std::thread> threads_;
+    std::mutex mtx_;
+    std::condition_variable work_cv_; // 작업이 들어옴
+    std::condition_variable done_cv_; // 작업 하나가 끝남
+    Job* head_ = nullptr;             // 남은 번호가 있는 작업 목록
+    bool stop_ = false;
+
+    // 잠근 상태에서 job의 다음 번호를 가져가고, 마지막 번호면 목록에서 뺌
+    bool take(Job& job, size_t& i) {
+        if (job.next >= job.n) {
+            return false;
+        }
+        i = job.next++;
+        if (job.next == job.n) {
+            Job** p = &head_;
+            while (*p != &job) {
+                p = &(*p)->link;
+            }
+            *p = job.link;
+        }
+        return true;
+    }
+
+    // 잠금을 풀고 fn(i) 실행 (앞에서 실패한 작업은 건너뜀), 다시 잠가 끝난 수를 셈
+    void execute(Job& job, size_t i, std::unique_lock<std::mutex>& lock) {
+        bool failed = static_cast<bool>(job.error);
+        lock.unlock();
+        std::exception_ptr err;
+        if (!failed) {
+            try {
+                job.call(job.fn, i);
+            } catch (...) {
+                err = std::current_exception();
+            }
+        }
+        lock.lock();
+        if (err && !job.error) {
+            job.error = err;
+        }
+        if (++job.done == job.n) {
+            done_cv_.notify_all();
+        }
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (true) {
+            work_cv_.wait(lock, [&]() { return stop_ || head_; });
+            if (!head_) {
+                return;
+            }
+            Job& job = *head_;
+            size_t i = 0;
+            take(job, i);
+            execute(job, i, lock);
+        }
+    }
+};
+
+} // namespace par
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,162 @@
+#ifndef REPORT_HPP
+#define REPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <array>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Mapping.hpp"
+#include "Bench.hpp"
+
+// 본 매핑 기록: 측정용 반복 실행이 인덱스를 바꾸기 전에 채움
+struct RunStats {
+    long long call_ms    = 0; // 컨센서스 생성 시간
+    size_t    vote_mem   = 0; // 투표 표 메모리 (창 모드이면 창 투표 표)
+    size_t    bins       = 0; // 창 모드 구간 수
+    size_t    bins_used  = 0; // 그중 기록이 들어와 상태를 만든 구간 수
+    size_t    bin_mem    = 0; // 구간 기록 버퍼 최대 바이트
+    uint64_t  spilled    = 0; // 디스크로 내린 바이트
+    size_t    kmer_k     = 0; // 본 매핑에 쓴 k-mer 표 길이
+    size_t    kmer_bytes = 0; // 그 표 메모리
+    size_t    peak_rss   = 0; // 본 매핑까지의 최대 상주 메모리 (뒤 측정의 SA, k-mer 표 제외)
+};
+
+// 샤드 수 (단일 인덱스는 1)
+inline size_t shard_count(const FMIndex&) { return 1; }
+inline size_t shard_count(const ShardedIndex& si) { return si.shard_count(); }
+
+// 검색 하나에서 동시에 검색하는 샤드 수
+inline size_t shard_query_threads(const FMIndex&) { return 1; }
+inline size_t shard_query_threads(const ShardedIndex& si) { return si.query_threads(); }
+
+// 타이밍 로그 (cfmindex_timing.txt): 본 매핑 기록과 측정용 반복 실행 결과
+template <typename Index>
+inline void write_timing(const Index& fm, const opt::Options& opts, int max_err, size_t ref_len,
+                         long long build_ms, bool loaded, const PipelineTimes& times,
+                         const RunStats& rs, const BenchResults& bench) {
+    auto stage_line = [](const stream::StageTime& st) {
+        return to_string(st.busy_us / 1000) + " / " + to_string(st.idle_us / 1000) + " ms\n";
+    };
+
+    long long total_ms = build_ms + times.wall_ms + rs.call_ms;
+    size_t read_cnt = times.read_cnt;
+    ofstream tfs("cfmindex_timing.txt");
+    if (tfs) {
+        tfs << (loaded ? "FM-index load time      : "
+                       : "FM-index build time     : ") << build_ms << " ms\n";
+        tfs << "Parse stage busy/idle   : " << stage_line(times.parse);
+        tfs << "Map stage busy/idle     : " << stage_line(times.map);
+        tfs << "Vote stage busy/idle    : " << stage_line(times.vote);
+        tfs << "Streaming stages time   : " << times.wall_ms << " ms\n";
+        tfs << "Consensus call time     : " << rs.call_ms << " ms\n";
+        tfs << "Total pipeline time     : " << total_ms  << " ms\n";
+        tfs << "OCC table memory        : " << fm.occ_bytes() << " bytes\n";
+        tfs << "Vote table memory       : " << rs.vote_mem << " bytes (was "
+            << ref_len * sizeof(array<int, 256>) << " bytes)\n";
+        tfs << "Windowed consensus      : ";
+        if (opts.window) {
+            tfs << "on (window " << opts.window << ", " << rs.bins << " bins, " << rs.bins_used << " with hits, " << rs.bin_mem
+                << " bytes peak bin buffers of " << (opts.bin_memory << 20) << " budget, "
+                << rs.spilled << " bytes spilled)\n";
+        } else {
+            tfs << "off\n";
+        }
+        tfs << "Mapping threads         : " << opts.threads << "\n";
+        tfs << "Hardware threads        : " << thread::hardware_concurrency() << "\n";
+        tfs << "Pipeline batch size     : " << opts.batch << " reads\n";
+        for (const auto& sc : bench.scaling) {
+            tfs << "Pipeline time (" << sc.first << " threads) : " << sc.second << " ms"
+                << (sc.first > thread::hardware_concurrency() ? " (more threads than hardware threads)" : "")
+                << "\n";
+        }
+        tfs << "SA sample rate          : " << fm.sa_rate() << " (" << fm.sa_bytes() << " bytes)\n";
+        tfs << "FM-index memory         : " << fm.memory_bytes() << " bytes\n";
+        tfs << "Index shards            : " << shard_count(fm);
+        if (shard_count(fm) > 1) {
+            tfs << " (overlap " << opts.shard_overlap << " bases, ";
+            if (shard_query_threads(fm) > 1) {
+                tfs << shard_query_threads(fm) << " shards searched in parallel per search)";
+            } else {
+                tfs << "shards searched in turn)";
+            }
+        }
+        tfs << "\n";
+        tfs << "K-mer table             : k=" << rs.kmer_k << ", " << rs.kmer_bytes << " bytes\n";
+        tfs << "Locate time per read    : " << per_read_us(times) << " us\n";
+        tfs << "Search mode             : " << (opts.scheme ? "scheme" : "backtrack") << "\n";
+        tfs << "Search nodes expanded   : " << times.nodes << "\n";
+        tfs << "Lower-bound pruning     : " << (opts.prune ? "on" : "off") << "\n";
+        tfs << "Anchor fast path        : " << (opts.exhaustive ? "on (exhaustive)" : opts.anchor ? "on" : "off") << "\n";
+        if (opts.anchor) {
+            size_t ar = times.anchor_reads;
+            tfs << "Anchor hit rate         : " << (ar ? 100.0 * times.anchor_hits / ar : 0.0)
+                << "% (" << times.anchor_hits << " / " << ar << " reads)\n";
+        }
+        if (opts.exhaustive) {
+            tfs << "Anchor missed hits      : " << times.anchor_short << " reads had other hits\n";
+        }
+        tfs << "Indel mode              : " << (opts.indels ? "on (D = edit distance)" : "off") << "\n";
+        if (opts.indels) {
+            double map_s = times.map.busy_us / 1e6;
+            tfs << "Indel mapped reads      : " << times.indel_mapped << " / " << read_cnt << " ("
+                << (read_cnt ? 100.0 * times.indel_mapped / read_cnt : 0.0) << "%)\n";
+            tfs << "Indel alignments        : " << times.indel_aligned << " verified, "
+                << times.indel_gapped << " hits with indels\n";
+            tfs << "Indel mapping throughput: " << (map_s > 0 ? read_cnt / map_s : 0.0) << " reads/s\n";
+        }
+        tfs << "Best-stratum search     : " << (opts.second_best ? "on (second best)" : opts.best ? "on" : "off") << "\n";
+        if (opts.best) {
+            size_t top = min<size_t>(max_err, MAX_STRATA - 1);
+            for (size_t d = 0; d <= top; d++) {
+                tfs << "Best stratum D=" << d << (d == MAX_STRATA - 1 ? "+" : " ") << "       : "
+                    << times.strata[d] << " reads\n";
+            }
+            tfs << "Best hits unique/multi  : " << times.best_unique << " / " << times.best_multi << " reads\n";
+            if (opts.second_best) {
+                tfs << "Second-best none/some   : " << times.second_none << " unique reads / "
+                    << times.second_some << " reads\n";
+            }
+            if (!opts.strata_path.empty()) {
+                tfs << "Per-read strata file    : " << opts.strata_path << "\n";
+            }
+        }
+        if (!opts.anchor && !opts.indels) {
+            static const char* MULTI_NAME[] = {"all", "skip", "weight"};
+            tfs << "Multi-mapping reads     : " << times.multi_reads << " (--multi " << MULTI_NAME[opts.multi]
+                << ", " << times.multi_skipped << " not resolved)\n";
+            tfs << "Positions found/resolved: " << times.hit_rows << " / " << times.hit_resolved << "\n";
+        }
+        tfs << "Positions memory (map)  : " << times.search_peak << " bytes peak per mapper\n";
+        tfs << "Positions memory (queue): " << times.flight_peak << " bytes peak in flight to vote\n";
+        tfs << "Fused map + vote        : " << (opts.fused ? (opts.threads > 1 ? "on (striped vote locks)" : "on") : "off") << "\n";
+        tfs << "Peak RSS                : " << rs.peak_rss << " bytes\n";
+        if (opts.prune_bench || opts.kmer_bench || opts.sa_bench) {
+            tfs << "Peak RSS (with benches) : " << io::peak_rss_bytes() << " bytes\n";
+        }
+        if (opts.max_hits) {
+            tfs << "Hit cap                 : " << opts.max_hits << " (" << times.capped << " reads skipped)\n";
+        }
+        if (bench.pruned) {
+            tfs << "Unpruned nodes expanded : " << bench.unpruned_nodes << "\n";
+            tfs << "Unpruned time per read  : " << bench.unpruned_us << " us\n";
+        }
+        for (const auto& sb : bench.sa) {
+            tfs << "Locate time per read (SA rate " << sb.rate << ") : " << sb.per_read_us << " us ("
+                << sb.bytes << " SA bytes)\n";
+        }
+        for (const auto& kb : bench.kmer) {
+            tfs << "Locate time per read (k=" << kb.first << ") : " << kb.second << " us";
+            if (kb.first && kb.second > 0.0) {
+                tfs << " (" << bench.kmer.front().second / kb.second << "x)";
+            }
+            tfs << "\n";
+        }
+    }
+}
+
+#endif // REPORT_HPP
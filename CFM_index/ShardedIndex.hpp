@@ -0,0 +1,268 @@
+#ifndef SHARDEDINDEX_HPP
+#define SHARDEDINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "Parallel.hpp"
+#include "Storage.hpp"
+#include "FMIndex.hpp"
+
+using namespace std;
+
+// 샤드: 레퍼런스 [start, start + owned + overlap)의 독립 FM-index
+// 시작 위치가 [start, start + owned)인 hit만 이 샤드 몫, 뒤 겹침 구간에서 시작하는 hit는 다음 샤드가 보고
+struct Shard {
+    size_t start;                 // 전역 시작 위치
+    size_t owned;                 // 이 샤드가 보고하는 시작 위치 수
+    size_t span;                  // 인덱스가 덮는 길이 (owned + 겹침, 레퍼런스 끝에서 잘림)
+    unique_ptr<FMIndex> index;
+};
+
+// 샤드 인덱스: 레퍼런스를 겹치는 샤드로 나누어 샤드마다 FM-index를 두고 모든 샤드를 검색
+// 길이가 overlap 이하인 패턴의 hit는 모두 어떤 샤드 하나에 통째로 들어가므로,
+// 각 샤드의 몫만 전역 위치로 옮기면 중복 없이 단일 인덱스와 같은 결과 (샤드 순서로 이어 붙이면 정렬됨)
+// 샤드 하나는 2^32 염기보다 작게 잡을 수 있어 구축 메모리를 줄이고 k-mer 표도 32bit 구간으로 유지
+class ShardedIndex {
+public:
+    // count개 샤드의 (시작, 몫, 길이): 몫은 고르게, 이웃과 overlap 염기 겹침
+    static vector<array<size_t, 3>> layout(size_t ref_len, size_t count, size_t overlap) {
+        count = max<size_t>(1, min(count, ref_len));
+        size_t owned = (ref_len + count - 1) / count;
+        vector<array<size_t, 3>> out;
+        for (size_t start = 0; start < ref_len || out.empty(); start += owned) {
+            size_t own = min(owned, ref_len - start);
+            out.push_back({start, own, min(own + overlap, ref_len - start)});
+        }
+        return out;
+    }
+
+    // 가장 긴 샤드 길이 (k-mer 표 자동 k 등)
+    static size_t max_span(size_t ref_len, size_t count, size_t overlap) {
+        size_t m = 0;
+        for (const auto& s : layout(ref_len, count, overlap)) {
+            m = max(m, s[2]);
+        }
+        return m;
+    }
+
+    // 샤드 구축: 샤드끼리 독립이므로 threads개씩 병렬 (스레드 하나면 최대 메모리는 샤드 하나 분량)
+    // 레퍼런스는 뷰로 받아 샤드 구간만 복사하므로 매핑한 파일도 통째로 읽어 들이지 않고 구축 가능
+    ShardedIndex(string_view reference, const IndexConfig& cfg, size_t count, size_t overlap,
+                 size_t threads)
+        : overlap_(overlap) {
+        init(reference.size(), count);
+        par::parallel_for(shards.size(), threads, 1, [&](size_t s, size_t) {
+            Shard& sh = shards[s];
+            sh.index = make_unique<FMIndex>(string(reference.substr(sh.start, sh.span)), cfg);
+        });
+    }
+
+    // 샤드 s의 인덱스 파일 경로
+    static string shard_path(const string& path, size_t s) {
+        return path + "." + to_string(s);
+    }
+
+    // 샤드마다 파일 하나 (path.0, path.1, ...): 샤드 부분 레퍼런스 체크섬으로 검증
+    void save(const string& path, const string& reference) const {
+        for (size_t s = 0; s < shards.size(); s++) {
+            const Shard& sh = shards[s];
+            sh.index->save(shard_path(path, s), store::checksum(reference.substr(sh.start, sh.span)));
+        }
+    }
+
+    // 저장된 샤드 파일을 매핑하여 로드 (샤드 수와 겹침이 구축 때와 다르면 체크섬 불일치로 실패)
+    static ShardedIndex load(const string& path, const string& reference, size_t count, size_t overlap) {
+        ShardedIndex si(overlap);
+        si.init(reference.size(), count);
+        for (size_t s = 0; s < si.shards.size(); s++) {
+            Shard& sh = si.shards[s];
+            sh.index = make_unique<FMIndex>(FMIndex::load(
+                shard_path(path, s), store::checksum(reference.substr(sh.start, sh.span))));
+        }
+        return si;
+    }
+
+    // 패턴 검색: 결과는 ctx.hits (전역 위치, 정렬 및 중복 제거됨)
+    // 샤드 결과를 위치로 합치므로 구간 모드(intervals_only)여도 위치를 복원함
+    // 검색 스레드가 둘 이상이면 샤드마다 작업 공간(ctx.shard_ctx)을 두고 상주 작업자와 함께 샤드를 동시에 검색
+    const vector<size_t>& locate(string_view pattern, int max_err, SearchContext& ctx) const {
+        check_length(pattern.size());
+        ctx.merged.clear();
+        bool capped = false;
+        if (fan_out()) {
+            if (ctx.shard_ctx.size() < shards.size()) {
+                ctx.shard_ctx.resize(shards.size());
+            }
+            pool_->run(shards.size(), [&](size_t s) {
+                SearchContext& sc = ctx.shard_ctx[s];
+                sc.mode = ctx.mode;
+                sc.prune = ctx.prune;
+                sc.max_hits = ctx.max_hits;
+                sc.intervals_only = false;
+                shards[s].index->locate(pattern, max_err, sc);
+            });
+            for (size_t s = 0; s < shards.size(); s++) {
+                SearchContext& sc = ctx.shard_ctx[s];
+                capped |= sc.capped;
+                ctx.nodes += sc.nodes;
+                sc.nodes = 0;
+                gather(shards[s], sc.hits, ctx);
+            }
+        } else {
+            bool keep = ctx.intervals_only;
+            ctx.intervals_only = false;
+            for (const Shard& sh : shards) {
+                sh.index->locate(pattern, max_err, ctx);
+                capped |= ctx.capped;
+                gather(sh, ctx.hits, ctx);
+            }
+            ctx.intervals_only = keep;
+        }
+        finish(ctx, capped);
+        return ctx.hits;
+    }
+
+    // 위치 수
+    size_t count(string_view pattern, int max_err, SearchContext& ctx) const {
+        locate(pattern, max_err, ctx);
+        return ctx.rows;
+    }
+
+    // 끝난 검색의 위치마다 sink(pos)
+    template <typename Sink>
+    void for_each_hit(const SearchContext& ctx, Sink&& sink) const {
+        for (size_t pos : ctx.hits) {
+            sink(pos);
+        }
+    }
+
+    // k-mer 구간 표 (재)구축: 모든 샤드
+    void build_kmers(size_t k) {
+        for (auto& sh : shards) {
+            sh.index->build_kmers(k);
+        }
+    }
+
+    // SA 샘플 (재)구축: 모든 샤드
+    void resample_sa(size_t rate) {
+        for (auto& sh : shards) {
+            sh.index->resample_sa(rate);
+        }
+    }
+
+    size_t kmer_k() const {
+        return shards.front().index->kmer_k();
+    }
+
+    bool has_reverse() const {
+        return shards.front().index->has_reverse();
+    }
+
+    size_t sa_rate() const {
+        return shards.front().index->sa_rate();
+    }
+
+    size_t sa_bytes() const {
+        return sum([](const FMIndex& fm) { return fm.sa_bytes(); });
+    }
+
+    size_t kmer_bytes() const {
+        return sum([](const FMIndex& fm) { return fm.kmer_bytes(); });
+    }
+
+    size_t occ_bytes() const {
+        return sum([](const FMIndex& fm) { return fm.occ_bytes(); });
+    }
+
+    size_t memory_bytes() const {
+        return sum([](const FMIndex& fm) { return fm.memory_bytes(); });
+    }
+
+    size_t shard_count() const {
+        return shards.size();
+    }
+
+    size_t overlap() const {
+        return overlap_;
+    }
+
+    // 검색 하나에서 샤드를 동시에 검색할 스레드 수 (1 = 샤드를 차례로 검색)
+    // 호출 스레드를 뺀 나머지는 인덱스가 살아 있는 동안 상주하는 작업자로 두어 검색마다 스레드를 만들지 않음
+    void set_query_threads(size_t threads) {
+        query_threads_ = max<size_t>(1, min(threads, shards.size()));
+        pool_.reset();
+        if (query_threads_ > 1) {
+            pool_ = make_unique<par::TaskPool>(query_threads_ - 1);
+        }
+    }
+
+    size_t query_threads() const {
+        return query_threads_;
+    }
+
+private:
+    explicit ShardedIndex(size_t overlap) : overlap_(overlap) {}
+
+    size_t overlap_;       // 이웃 샤드와 겹치는 염기 수 (검색 가능한 최대 패턴 길이)
+    size_t query_threads_ = 1; // 검색 하나에서 샤드를 동시에 검색할 스레드 수
+    vector<Shard> shards;
+    unique_ptr<par::TaskPool> pool_; // 샤드 검색 작업자 (query_threads_ - 1개)
+
+    bool fan_out() const {
+        return pool_ != nullptr;
+    }
+
+    void init(size_t ref_len, size_t count) {
+        for (const auto& s : layout(ref_len, count, overlap_)) {
+            shards.push_back(Shard{s[0], s[1], s[2], nullptr});
+        }
+    }
+
+    // 겹침보다 긴 패턴은 두 샤드 경계를 모두 넘는 hit를 놓칠 수 있음
+    void check_length(size_t m) const {
+        if (shards.size() > 1 && m > overlap_) {
+            throw invalid_argument("pattern of length " + to_string(m) + " is longer than the shard overlap "
+                                   + to_string(overlap_) + "; raise --shard-overlap");
+        }
+    }
+
+    // 샤드 검색 결과 hits 중 이 샤드 몫을 전역 위치로 옮겨 ctx.merged에 모음 (샤드 결과는 정렬되어 있음)
+    static void gather(const Shard& sh, const vector<size_t>& hits, SearchContext& ctx) {
+        for (size_t pos : hits) {
+            if (pos >= sh.owned) {
+                break;
+            }
+            ctx.merged.push_back(sh.start + pos);
+        }
+    }
+
+    // 모은 위치를 결과로: 어느 샤드든 상한을 넘었거나 합이 넘으면 비움
+    // 맞바꾸지 않고 복사: 맞바꾸면 두 버퍼가 번갈아 결과가 되어 데운 뒤에도 작은 쪽이 다시 커질 수 있음
+    static void finish(SearchContext& ctx, bool capped) {
+        ctx.hits.assign(ctx.merged.begin(), ctx.merged.end());
+        ctx.intervals.clear();
+        ctx.rows = ctx.hits.size();
+        ctx.capped = capped || ctx.rows > ctx.max_hits;
+        if (ctx.capped) {
+            ctx.hits.clear();
+        }
+    }
+
+    template <typename F>
+    size_t sum(F&& f) const {
+        size_t total = 0;
+        for (const auto& sh : shards) {
+            total += f(*sh.index);
+        }
+        return total;
+    }
+};
+
+#endif // SHARDEDINDEX_HPP
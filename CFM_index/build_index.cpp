@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Storage.hpp"
+#include "FMIndex.hpp"
+#include "ShardedIndex.hpp"
+
+using namespace std;
+using namespace chrono;
+
+// 레퍼런스로 FM-index를 구축하여 파일로 저장
+int main(int argc, char* argv[]) {
+    const string ref_path = "reference.txt"; // 레퍼런스 파일
+
+    opt::Options opts;
+    try {
+        opts = opt::parse_options(argc, argv);
+        // 인덱스 내용을 정하는 옵션만 받음 (--search scheme, --prune은 역방향 BWT, --threads는 샤드 병렬 구축)
+        vector<string> used = {"--sa-rate", "--search", "--prune", "--kmer", "--shards", "--index"};
+        if (opts.shards > 1) {
+            used.insert(used.end(), {"--shard-overlap", "--threads"});
+        }
+        opt::reject_unused(opts, used, opts.shards > 1 ? "build_index" : "build_index without --shards");
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    const string idx_path = opts.index_path.empty() ? "cfmindex.idx" : opts.index_path;
+
+    try {
+        string reference = io::read_reference(ref_path);
+
+        auto t_s = high_resolution_clock::now();
+        IndexConfig cfg;
+        cfg.sa_rate = opts.sa_rate;
+        cfg.bidirectional = opts.scheme || opts.prune;
+        if (opts.shards > 1) {
+            // 샤드마다 파일 하나 (idx_path.0, idx_path.1, ...), 검색 때 같은 --shards, --shard-overlap 필요
+            size_t span = ShardedIndex::max_span(reference.size(), opts.shards, opts.shard_overlap);
+            cfg.kmer_k = (opts.kmer == opt::KMER_AUTO) ? kmer::auto_k(span + 1) : opts.kmer;
+            ShardedIndex si(reference, cfg, opts.shards, opts.shard_overlap, opts.threads);
+            si.save(idx_path, reference);
+        } else {
+            cfg.kmer_k = (opts.kmer == opt::KMER_AUTO) ? kmer::auto_k(reference.size() + 1) : opts.kmer;
+            FMIndex fm(reference, cfg);
+            fm.save(idx_path, store::checksum(reference));
+        }
+        auto t_e = high_resolution_clock::now();
+
+        cout << "Index written: " << idx_path << (opts.shards > 1 ? ".*" : "") << " ("
+             << duration_cast<milliseconds>(t_e - t_s).count() << " ms)\n";
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -2,15 +2,26 @@
 #include <string>
 #include <vector>
 #include "IOUtils.hpp"
+#include "Options.hpp"
 #include "Assemble.hpp"
 
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
     const string ref_path  = "reference.txt";          // 레퍼런스 파일
     const string read_path = "reads.txt";              // 리드 파일
     const string out_path  = "cfmindex_assembled.txt"; // 결과 출력 파일
 
+    // 명령행 옵션
+    opt::Options opts;
+    try {
+        opts = opt::parse_options(argc, argv);
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
     // 사용자 입력
     int max_err = 0;
     cout << "Enter max mismatch (D): ";
@@ -21,14 +32,10 @@ int main() {
 
     try {
         // 입력 로드
-        string reference          = io::read_reference(ref_path);
-        vector<string> reads = io::read_reads(read_path);
-
-        // 어셈블 호출
-        string assembled = assemble_reads(reference, reads, max_err);
+        string reference = io::read_reference(ref_path);
 
-        // 결과 저장
-        io::write_text(out_path, assembled);
+        // 어셈블 호출: 리드는 파이프라인에서 배치 단위로 읽고, 결과는 out_path에 저장
+        assemble_reads(reference, read_path, out_path, max_err, opts);
         cout << "Assembly finished. Output: " << out_path << "\n";
     }
     catch (const exception& e) {
@@ -13,11 +13,51 @@ char mutate_base(char b, mt19937& g) {
     return bases[(idx + d(g)) % 4];
 }
 
-int main() {
+// 리드 염기마다 rate 확률로 삽입 또는 삭제 (반반) 오류 추가
+string add_indels(const string& read, double rate, mt19937& g) {
+    static const char bases[4] = {'A', 'C', 'G', 'T'};
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    uniform_int_distribution<int> pick(0, 3);
+    string out;
+    out.reserve(read.size() + 8);
+    for (char b : read) {
+        double x = coin(g);
+        if (x < rate / 2) {
+            continue;               // 삭제
+        }
+        out += b;
+        if (x < rate) {
+            out += bases[pick(g)];  // 삽입
+        }
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
     const string ref_filename   = "reference.txt";
     const string reads_filename = "reads.txt";
     const string mut_filename   = "reference_mutated.txt";
 
+    // 명령행 옵션: --indel-rate P (염기당 삽입/삭제 확률, %)
+    double indel_rate = 0.0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--indel-rate" && i + 1 < argc) {
+            try {
+                indel_rate = stod(argv[++i]) / 100.0;
+            } catch (const exception&) {
+                indel_rate = -1.0;
+            }
+            if (indel_rate < 0.0 || indel_rate > 1.0) {
+                cerr << "Invalid indel rate.\n";
+                return 1;
+            }
+        } else {
+            cerr << "Unknown option: " << arg << '\n';
+            return 1;
+        }
+    }
+
     long long read_len = 0;
     int repeat_cnt = 0;
     int max_mis = 0;
@@ -97,7 +137,11 @@ int main() {
     for (int r = 0; r < repeat_cnt; r++) {
         long long start_idx = dis_start(gen);
         for (long long pos = start_idx; pos + read_len <= static_cast<long long>(mut.size()); pos += read_len) {
-            reads_ofs << mut.substr(pos, read_len) << ',';
+            string read = mut.substr(pos, read_len);
+            if (indel_rate > 0.0) {
+                read = add_indels(read, indel_rate, gen);
+            }
+            reads_ofs << read << ',';
         }
     }
     reads_ofs.close();
@@ -0,0 +1,249 @@
+#ifndef ASSEMBLE_HPP
+#define ASSEMBLE_HPP
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Pipeline.hpp"
+#include "FMIndex.hpp"
+#include "Consensus.hpp"
+
+using namespace std;
+using namespace chrono;
+
+constexpr size_t QUEUE_DEPTH = 2; // 매퍼 스레드당 큐에 대기할 수 있는 배치 수
+
+// 매핑 결과 배치: (배치 내 리드 번호, 위치)
+struct HitBatch {
+    vector<string_view> reads;
+    vector<pair<size_t, size_t>> hits;
+};
+
+// 다 쓴 배치를 비움: 용량은 남겨 다음 배치가 할당 없이 채움
+inline void reset(HitBatch& b) {
+    b.reads.clear();
+    b.hits.clear();
+}
+
+// 파이프라인 단계별 시간
+struct PipelineTimes {
+    stream::StageTime parse;
+    stream::StageTime map;
+    stream::StageTime vote;
+    long long wall_ms = 0;
+    size_t read_cnt = 0;
+};
+
+// 스트리밍 파이프라인: 파서 -> 매퍼 스레드 -> 투표
+// 각 큐 용량이 고정되어 있어 메모리는 입력 크기가 아닌 배치 크기에 비례
+template <size_t K>
+void run_pipeline(const FMIndex<K>& fm, const io::MappedFile& file, int max_err,
+                         size_t threads, size_t batch, consensus::VoteTable& votes,
+                         size_t ref_len, PipelineTimes& times) {
+    stream::BoundedQueue<HitBatch> read_q(threads * QUEUE_DEPTH);
+    stream::BoundedQueue<HitBatch> hit_q(threads * QUEUE_DEPTH);
+    // 다 쓴 배치를 파서에 돌려주는 큐: 동시에 살아 있을 수 있는 배치 수
+    // (두 큐 + 매퍼마다 하나 + 파서 + 투표)만큼 미리 넣어 두어 데운 뒤에는 배치를 새로 만들지 않음
+    stream::BoundedQueue<HitBatch> spare_q(2 * threads * QUEUE_DEPTH + threads + 2);
+    for (size_t i = 0; i < 2 * threads * QUEUE_DEPTH + threads + 2; i++) {
+        spare_q.push(HitBatch());
+    }
+
+    exception_ptr error;
+    mutex error_mtx;
+    auto fail = [&]() {
+        lock_guard<mutex> lock(error_mtx);
+        if (!error) {
+            error = current_exception();
+        }
+        read_q.close();
+        hit_q.close();
+    };
+
+    auto t_start = high_resolution_clock::now();
+
+    // 파서: 매핑된 파일을 배치로 분리
+    thread parser([&]() {
+        try {
+            stream::StageClock clock(times.parse);
+            io::ReadScanner scanner(file.data(), file.size());
+            HitBatch next;
+            spare_q.try_pop(next);
+            while (scanner.next(next.reads, batch)) {
+                times.read_cnt += next.reads.size();
+                clock.busy();
+                if (!read_q.push(std::move(next))) {
+                    break;
+                }
+                clock.idle();
+                if (!spare_q.try_pop(next)) {
+                    next = HitBatch();
+                }
+            }
+            read_q.close();
+        } catch (...) {
+            fail();
+        }
+    });
+
+    // 매퍼: 배치 단위로 가져가므로 오래 걸리는 리드가 다른 스레드를 막지 않음
+    atomic<size_t> active{threads};
+    vector<thread> mappers;
+    mappers.reserve(threads);
+    for (size_t t = 0; t < threads; t++) {
+        mappers.emplace_back([&]() {
+            try {
+                stream::StageClock clock(times.map);
+                SearchContext<K> ctx;
+                HitBatch out;
+                while (read_q.pop(out)) {
+                    clock.idle();
+                    for (size_t i = 0; i < out.reads.size(); i++) {
+                        // 빈 리드는 모든 위치에 매칭되지만 투표에 기여하지 않으므로 건너뜀
+                        if (out.reads[i].empty()) {
+                            continue;
+                        }
+                        for (size_t pos : fm.locate(out.reads[i], max_err, ctx)) {
+                            out.hits.emplace_back(i, pos);
+                        }
+                    }
+                    clock.busy();
+                    if (!hit_q.push(std::move(out))) {
+                        break;
+                    }
+                    clock.idle();
+                }
+            } catch (...) {
+                fail();
+            }
+            if (--active == 0) {
+                hit_q.close();
+            }
+        });
+    }
+
+    // 투표: 도착하는 순서대로 반영 (덧셈이므로 순서와 무관하게 결과 동일)
+    {
+        stream::StageClock clock(times.vote);
+        HitBatch in;
+        while (hit_q.pop(in)) {
+            clock.idle();
+            for (const auto& hit : in.hits) {
+                const auto& read = in.reads[hit.first];
+                // 범위 벗어나면 스킵
+                if (hit.second + read.size() > ref_len) {
+                    continue;
+                }
+                votes.add_read(hit.second, read);
+            }
+            reset(in);
+            spare_q.try_push(in);
+            clock.busy();
+        }
+    }
+
+    parser.join();
+    for (auto& th : mappers) {
+        th.join();
+    }
+    auto t_end = high_resolution_clock::now();
+    times.wall_ms = duration_cast<milliseconds>(t_end - t_start).count();
+
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+// 어셈블 함수: 심볼당 K염기 인덱스
+template <size_t K>
+string assemble_reads(const string& reference, const string& read_path, int max_err,
+                      const opt::Options& opts) {
+    // 로드한 인덱스는 저장할 때의 SA 샘플링 간격을 그대로 씀
+    if (!opts.index_path.empty() && opt::given(opts, "--sa-rate")) {
+        throw invalid_argument("--sa-rate has no effect with --index; the index file keeps the rate it was built with");
+    }
+    size_t ref_len = reference.size();
+    io::MappedFile read_file = io::map_read_file(read_path);
+
+    // FM-index 구축 (인덱스 파일이 주어지면 매핑 로드)
+    auto t_build_start = high_resolution_clock::now();
+    bool loaded = !opts.index_path.empty();
+    FMIndex<K> fm = loaded ? FMIndex<K>::load(opts.index_path, store::checksum(reference))
+                           : FMIndex<K>(reference, opts.sa_rate);
+    auto t_build_end   = high_resolution_clock::now();
+    long long build_ms = duration_cast<milliseconds>(t_build_end - t_build_start).count();
+
+    // 스케일링 측정: 1, 2, 4, ... 매퍼 스레드와 --threads 자체
+    vector<pair<size_t, long long>> scaling;
+    if (opts.scaling) {
+        for (size_t t = 1;; t = min(t * 2, opts.threads)) {
+            consensus::VoteTable scratch(ref_len);
+            PipelineTimes st;
+            run_pipeline(fm, read_file, max_err, t, opts.batch, scratch, ref_len, st);
+            scaling.emplace_back(t, st.wall_ms);
+            if (t == opts.threads) {
+                break;
+            }
+        }
+    }
+
+    // 파싱, 매핑, 투표를 겹쳐서 실행
+    consensus::VoteTable votes(ref_len);
+    PipelineTimes times;
+    run_pipeline(fm, read_file, max_err, opts.threads, opts.batch, votes, ref_len, times);
+
+    // 컨센서스 문자열 생성
+    auto t_call_start = high_resolution_clock::now();
+    string assembled = votes.call();
+    auto t_call_end = high_resolution_clock::now();
+    long long call_ms = duration_cast<milliseconds>(t_call_end - t_call_start).count();
+
+    size_t read_cnt = times.read_cnt;
+    double per_read_us = read_cnt ? static_cast<double>(times.map.busy_us) / read_cnt : 0.0;
+    auto stage_line = [](const stream::StageTime& st) {
+        return to_string(st.busy_us / 1000) + " / " + to_string(st.idle_us / 1000) + " ms\n";
+    };
+
+    // 타이밍 로그
+    long long total_ms = build_ms + times.wall_ms + call_ms;
+    ofstream tfs("kfmindex_timing.txt");
+    if (tfs) {
+        tfs << (loaded ? "FM-index load time      : "
+                       : "FM-index build time     : ") << build_ms << " ms\n";
+        tfs << "Parse stage busy/idle   : " << stage_line(times.parse);
+        tfs << "Map stage busy/idle     : " << stage_line(times.map);
+        tfs << "Vote stage busy/idle    : " << stage_line(times.vote);
+        tfs << "Streaming stages time   : " << times.wall_ms << " ms\n";
+        tfs << "Consensus call time     : " << call_ms   << " ms\n";
+        tfs << "Total pipeline time     : " << total_ms  << " ms\n";
+        tfs << "Vote table memory       : " << votes.bytes() << " bytes (was "
+            << ref_len * sizeof(array<int, 256>) << " bytes)\n";
+        tfs << "Mapping threads         : " << opts.threads << "\n";
+        tfs << "Hardware threads        : " << thread::hardware_concurrency() << "\n";
+        tfs << "Pipeline batch size     : " << opts.batch << " reads\n";
+        for (const auto& sc : scaling) {
+            tfs << "Pipeline time (" << sc.first << " threads) : " << sc.second << " ms"
+                << (sc.first > thread::hardware_concurrency() ? " (more threads than hardware threads)" : "")
+                << "\n";
+        }
+        tfs << "Bases per symbol        : " << K << "\n";
+        tfs << "SA sample rate          : " << fm.sa_rate() << "\n";
+        tfs << "FM-index memory         : " << fm.memory_bytes() << " bytes\n";
+        tfs << "Locate time per read    : " << per_read_us << " us\n";
+    }
+
+    return assembled;
+}
+
+#endif // ASSEMBLE_HPP
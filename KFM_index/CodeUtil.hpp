@@ -0,0 +1,148 @@
+#ifndef CODEUTIL_HPP
+#define CODEUTIL_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace code {
+
+// 센티넬 코드
+constexpr uint8_t SENT_CODE = 0x0; // '$'
+// 패딩 코드
+constexpr uint8_t PAD_CODE  = 0xF; // 'N'
+
+// 염기 -> 코드 변환 (OccTable과 같은 4bit 코드)
+inline uint8_t encode_base(char c)
+{
+    switch (c) {
+        case 'A': return 0x1;
+        case 'C': return 0x5;
+        case 'G': return 0x9;
+        case 'T': return 0xD;
+        case '$': return SENT_CODE;
+        case 'N': return PAD_CODE;       // 패딩용
+        default:  throw std::invalid_argument("encode_base: invalid base");
+    }
+}
+
+// 코드 -> 인덱스 변환
+inline int code_to_idx(uint8_t code)
+{
+    switch (code & 0xF) {
+        case 0x1: return 1;   // A
+        case 0x5: return 2;   // C
+        case 0x9: return 3;   // G
+        case 0xD: return 4;   // T
+        case 0x0: return 0;   // $
+        default:  throw std::invalid_argument("code_to_idx: invalid code");
+    }
+}
+
+// 염기 -> 2bit 값 (A=0, C=1, G=2, T=3)
+inline unsigned base_bits(char c)
+{
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default:  throw std::invalid_argument("base_bits: invalid base");
+    }
+}
+
+// K개 염기를 하나의 심볼로 묶는 알파벳
+// 심볼 0 = '$', 1 + (첫 염기가 최상위 2bit인 K염기 값) = 사전식 순서
+// 리드 패턴 심볼은 N 염기를 담을 수 있도록 더 넓음: 하위 16bit = 심볼 (N은 A 자리), 그 위 = N 염기 마스크
+template <std::size_t K>
+struct Alphabet {
+    static_assert(K >= 1 && K <= 4, "Alphabet: 1 to 4 bases per symbol");
+
+    static constexpr std::size_t BASES  = K;
+    static constexpr std::size_t GROUPS = std::size_t(1) << (2 * K);  // 4^K
+    static constexpr std::size_t SIGMA  = GROUPS + 1;                  // '$' 포함
+    using symbol_t = typename std::conditional<(SIGMA <= 256), uint8_t, uint16_t>::type;
+    using pattern_t = uint32_t;
+    static constexpr unsigned N_SHIFT = 16; // 패턴 심볼의 N 마스크 위치 (염기 j의 bit = 심볼 값의 2bit 칸 j)
+
+    // seq[0, K) -> 심볼
+    static symbol_t pack(const char* seq) {
+        unsigned v = 0;
+        for (std::size_t j = 0; j < K; j++) {
+            v = (v << 2) | base_bits(seq[j]);
+        }
+        return static_cast<symbol_t>(1 + v);
+    }
+
+    // 리드 seq[0, K) -> 패턴 심볼: 'N'은 cfmindex의 PAD_CODE처럼 어떤 염기와도 일치하지 않음
+    static pattern_t pack_pattern(const char* seq) {
+        unsigned v = 0, n_mask = 0;
+        for (std::size_t j = 0; j < K; j++) {
+            bool n = (seq[j] == 'N');
+            v = (v << 2) | (n ? 0 : base_bits(seq[j]));
+            n_mask = (n_mask << 1) | (n ? 1 : 0);
+        }
+        return (1 + v) | (n_mask << N_SHIFT);
+    }
+
+    // 패턴 심볼에 N 염기가 있는지 (있으면 정확히 일치하는 심볼이 없음)
+    static bool has_n(pattern_t p) {
+        return (p >> N_SHIFT) != 0;
+    }
+
+    // 패턴 심볼의 심볼 값 (N이 없을 때 그대로 검색에 씀)
+    static symbol_t symbol(pattern_t p) {
+        return static_cast<symbol_t>(p & ((1u << N_SHIFT) - 1));
+    }
+
+    // 심볼 a와 패턴 심볼 p에서 서로 다른 염기 수 (0 ~ K, N 염기는 항상 다름)
+    static int mismatch(symbol_t a, pattern_t p) {
+        unsigned x = static_cast<unsigned>(a - 1) ^ static_cast<unsigned>(symbol(p) - 1);
+        unsigned n_mask = p >> N_SHIFT;
+        int cnt = 0;
+        for (std::size_t j = 0; j < K; j++) {
+            cnt += (((x >> (2 * j)) & 0x3) || ((n_mask >> j) & 1)) ? 1 : 0;
+        }
+        return cnt;
+    }
+};
+
+// 문자열 -> 심볼 텍스트: 남는 염기(K 미만)는 버리고 '$' 추가
+template <std::size_t K>
+std::vector<typename Alphabet<K>::symbol_t> pack_text(std::string_view seq) {
+    std::vector<typename Alphabet<K>::symbol_t> res;
+    res.reserve(seq.size() / K + 1);
+    for (std::size_t i = 0; i + K <= seq.size(); i += K) {
+        res.push_back(Alphabet<K>::pack(seq.data() + i));
+    }
+    res.push_back(0);
+    return res;
+}
+
+// 리드 -> 패턴 심볼 (out 재사용, '$' 없음, 남는 염기는 버림)
+template <std::size_t K>
+void pack_pattern_into(std::string_view seq, std::vector<typename Alphabet<K>::pattern_t>& out) {
+    out.resize(seq.size() / K);
+    for (std::size_t i = 0; i < out.size(); i++) {
+        out[i] = Alphabet<K>::pack_pattern(seq.data() + i * K);
+    }
+}
+
+// 문자열 -> 4bit 팩킹 (홀수 길이면 마지막 하위 4bit는 0)
+inline std::vector<uint8_t> pack_nibbles(std::string_view seq) {
+    std::vector<uint8_t> res((seq.size() + 1) / 2, 0);
+    for (std::size_t i = 0; i < seq.size(); ++i) {
+        uint8_t c = encode_base(seq[i]);
+        res[i >> 1] |= static_cast<uint8_t>((i & 1) ? c : (c << 4));
+    }
+    return res;
+}
+
+} // namespace code
+
+#endif // CODEUTIL_HPP
@@ -0,0 +1,350 @@
+#ifndef FMINDEX_HPP
+#define FMINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "CodeUtil.hpp"
+#include "IOUtils.hpp"
+#include "Storage.hpp"
+#include "SuffixArray.hpp"
+#include "SampledSA.hpp"
+#include "SymbolOcc.hpp"
+
+using namespace std;
+
+// 인덱스 파일 형식
+static constexpr char     INDEX_MAGIC[8] = "KFMIDX";
+static constexpr uint32_t INDEX_VERSION  = 2;
+
+// 인덱스 파일 헤더
+struct IndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t word_size;     // sizeof(size_t)
+    uint64_t ref_checksum;  // 레퍼런스 FNV-1a 체크섬
+    uint64_t length;        // 레퍼런스 길이 (염기 단위)
+    uint32_t bases;         // 심볼당 염기 수 K
+    uint32_t reserved;
+};
+
+// 검색 스택 항목
+struct SearchFrame {
+    int    idx;    // 다음에 맞출 패턴 위치 (심볼 단위)
+    size_t left;   // SA 구간 시작
+    size_t right;  // SA 구간 끝
+    int    errs;   // 남은 mismatch 허용 수
+};
+
+// 검색 작업 공간: 스레드마다 하나씩 두고 재사용하면 검색 중 할당 없음
+template <size_t K>
+struct SearchContext {
+    vector<SearchFrame> stack;   // DFS 스택
+    vector<typename code::Alphabet<K>::pattern_t> pattern; // 패턴 심볼 (N 염기 마스크 포함)
+    vector<size_t>      hits;    // 결과 위치
+};
+
+// 한 위상(phase)의 심볼 FM-index: 레퍼런스를 phase 염기만큼 민 뒤 K염기씩 묶음
+template <size_t K>
+class SymbolFrame {
+public:
+    using Alpha  = code::Alphabet<K>;
+    using Sym    = typename Alpha::symbol_t;
+    using Occ    = typename occ::OccFor<K>::type;
+
+    SymbolFrame() = default;
+
+    // 심볼 텍스트('$' 포함)로 구축
+    void build(const vector<Sym>& text, size_t sa_rate) {
+        length = text.size();
+        vector<size_t> sa = suffix::sais(text, Alpha::SIGMA);
+
+        vector<Sym> bwt(length);
+        for (size_t i = 0; i < length; i++) {
+            size_t pos = (sa[i] == 0) ? (length - 1) : (sa[i] - 1);
+            bwt[i] = text[pos];
+        }
+
+        // C 구축
+        C.fill(0);
+        for (Sym s : bwt) {
+            C[s]++;
+        }
+        uint64_t sum = 0;
+        for (size_t k = 0; k < C.size(); k++) {
+            uint64_t cnt = C[k];
+            C[k] = sum;
+            sum += cnt;
+        }
+
+        occ.build(bwt);
+        ssa.build(std::move(sa), sa_rate);
+    }
+
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(length));
+        w.put(C);
+        occ.save(w);
+        ssa.save(w);
+    }
+
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        length = static_cast<size_t>(r.get<uint64_t>());
+        C = r.get<array<uint64_t, Alpha::SIGMA>>();
+        occ.load(r);
+        ssa.load(r);
+    }
+
+    // 심볼 c를 앞에 붙였을 때 구간 경계 i의 새 위치
+    inline size_t extend(int c, size_t i) const {
+        return C[c] + occ.rank(c, i);
+    }
+
+    // bwt[i]의 심볼
+    inline int symbol(size_t i) const {
+        return occ.symbol(i);
+    }
+
+    // SA 값 조회: 샘플이 아니면 LF로 거슬러 올라감
+    inline size_t sa_value(size_t row) const {
+        return ssa.lookup(row, [this](size_t r) { return extend(occ.symbol(r), r); });
+    }
+
+    size_t rows() const {
+        return length;
+    }
+
+    size_t sa_rate() const {
+        return ssa.rate();
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return ssa.bytes() + occ.bytes() + sizeof(C);
+    }
+
+private:
+    size_t length = 0;                   // 심볼 텍스트 길이
+    suffix::SampledSA ssa;               // 샘플링 SA
+    array<uint64_t, Alpha::SIGMA> C;     // 누적 빈도 배열 (64bit: 2^32 행 이상)
+    Occ occ;                             // K별 랭크 사전
+};
+
+// 심볼당 K염기 FM-index: K개 위상으로 모든 시작 위치를 검색하고
+// K로 나누어 떨어지지 않는 리드 끝 염기는 레퍼런스와 직접 비교
+template <size_t K>
+class FMIndex {
+public:
+    using Alpha = code::Alphabet<K>;
+    using Sym   = typename Alpha::symbol_t;
+    using Context = SearchContext<K>;
+
+    // 구간이 이보다 작으면 모든 심볼 대신 구간에 실제로 있는 심볼만 확장
+    static constexpr size_t SCAN_ROWS = 16;
+
+    // 생성자: K개 위상의 FM-Index 구축, sa_rate 간격으로 SA 샘플링
+    FMIndex(const string& reference, size_t sa_rate = 1) {
+        ref_len = reference.size();
+        for (size_t phase = 0; phase < K; phase++) {
+            string_view shifted(reference);
+            shifted.remove_prefix(min(phase, shifted.size()));
+            frames[phase].build(code::pack_text<K>(shifted), sa_rate);
+        }
+        ref_nibbles = code::pack_nibbles(reference);
+    }
+
+    // 패턴 검색: max_err 만큼 mismatch 허용
+    vector<size_t> locate(string_view pattern, int max_err) const {
+        Context ctx;
+        locate(pattern, max_err, ctx);
+        return std::move(ctx.hits);
+    }
+
+    // 패턴 검색 (작업 공간 재사용): 결과는 ctx.hits, 정렬 및 중복 제거됨
+    const vector<size_t>& locate(string_view pattern, int max_err, Context& ctx) const {
+        code::pack_pattern_into<K>(pattern, ctx.pattern);
+        ctx.hits.clear();
+        for (size_t phase = 0; phase < K; phase++) {
+            search_frame(phase, pattern, max_err, ctx);
+        }
+
+        auto& result = ctx.hits;
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // 인덱스 전체 메모리 (바이트)
+    size_t memory_bytes() const {
+        size_t sum = ref_nibbles.bytes();
+        for (const auto& fr : frames) {
+            sum += fr.bytes();
+        }
+        return sum;
+    }
+
+    // SA 샘플링 간격
+    size_t sa_rate() const {
+        return frames[0].sa_rate();
+    }
+
+    // 인덱스 파일 저장
+    void save(const string& path, uint64_t ref_checksum) const {
+        store::Writer w(path);
+        IndexHeader hdr{};
+        memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+        hdr.version      = INDEX_VERSION;
+        hdr.word_size    = sizeof(size_t);
+        hdr.ref_checksum = ref_checksum;
+        hdr.length       = ref_len;
+        hdr.bases        = static_cast<uint32_t>(K);
+        w.put(hdr);
+        for (const auto& fr : frames) {
+            fr.save(w);
+        }
+        w.put_array(ref_nibbles);
+        w.finish();
+    }
+
+    // 인덱스 파일을 읽기 전용으로 매핑하여 로드
+    static FMIndex load(const string& path, uint64_t ref_checksum) {
+        FMIndex fm;
+        fm.file = io::MappedFile(path);
+        store::Reader r(fm.file.data(), fm.file.size());
+
+        auto hdr = r.get<IndexHeader>();
+        if (memcmp(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic)) != 0) {
+            throw runtime_error("not a KFM index file: " + path);
+        }
+        if (hdr.version != INDEX_VERSION || hdr.word_size != sizeof(size_t)) {
+            throw runtime_error("unsupported index version: " + path);
+        }
+        if (hdr.bases != K) {
+            throw runtime_error("index was built with " + to_string(hdr.bases)
+                                + " bases per symbol: " + path);
+        }
+        if (hdr.ref_checksum != ref_checksum) {
+            throw runtime_error("index does not match reference: " + path);
+        }
+
+        fm.ref_len = static_cast<size_t>(hdr.length);
+        for (auto& fr : fm.frames) {
+            fr.load(r);
+        }
+        r.get_array(fm.ref_nibbles);
+        return fm;
+    }
+
+private:
+    FMIndex() = default;
+
+    io::MappedFile file;                 // 로드 시 매핑된 인덱스 파일
+    size_t ref_len = 0;                  // 레퍼런스 길이 (염기 단위)
+    array<SymbolFrame<K>, K> frames;     // 위상 p: ref[p..]
+    store::Array<uint8_t> ref_nibbles;   // 4bit 팩킹 레퍼런스 (끝 염기 확인용)
+
+    // 레퍼런스 pos 위치 염기 코드
+    inline uint8_t ref_code(size_t pos) const {
+        uint8_t byte = ref_nibbles[pos >> 1];
+        return (pos & 1) ? (byte & 0x0F) : (byte >> 4);
+    }
+
+    // 리드의 남는 끝 염기 [tail, read_len) 중 레퍼런스와 다른 수
+    // 'N'은 PAD_CODE로 바뀌고 레퍼런스에는 없으므로 패턴 심볼 경로와 같이 항상 mismatch
+    inline int tail_mismatch(string_view read, size_t tail, size_t pos) const {
+        int cnt = 0;
+        for (size_t j = tail; j < read.size(); j++) {
+            cnt += (ref_code(pos + j) != code::encode_base(read[j]));
+        }
+        return cnt;
+    }
+
+    // 한 위상에서 심볼 패턴 검색, 결과는 염기 좌표로 ctx.hits에 추가
+    void search_frame(size_t phase, string_view read, int max_err, Context& ctx) const {
+        const SymbolFrame<K>& fr = frames[phase];
+        const auto& pat = ctx.pattern;
+        auto& stk = ctx.stack;
+        auto& result = ctx.hits;
+        size_t read_len = read.size();
+        size_t tail = pat.size() * K; // 심볼로 묶이지 않은 끝 염기 시작
+
+        stk.clear();
+        stk.push_back({static_cast<int>(pat.size()) - 1, 0, fr.rows(), max_err});
+
+        while (!stk.empty()) {
+            SearchFrame cur = stk.back();
+            stk.pop_back();
+
+            if (cur.errs < 0 || cur.left >= cur.right) {
+                continue;
+            }
+
+            // 패턴 끝 도달시 SA 구간의 위치 추가
+            if (cur.idx < 0) {
+                for (size_t i = cur.left; i < cur.right; i++) {
+                    size_t pos = fr.sa_value(i) * K + phase; // 심볼 -> 염기 좌표
+                    if (pos + read_len > ref_len) {
+                        continue;
+                    }
+                    if (tail < read_len && tail_mismatch(read, tail, pos) > cur.errs) {
+                        continue;
+                    }
+                    result.push_back(pos);
+                }
+                continue;
+            }
+
+            // 허용 mismatch가 남지 않았으면 패턴 심볼 하나만 확장 가능 (N이 있으면 일치하는 심볼 없음)
+            auto target = pat[cur.idx];
+            if (cur.errs == 0) {
+                if (!Alpha::has_n(target)) {
+                    int t = Alpha::symbol(target);
+                    stk.push_back({cur.idx - 1, fr.extend(t, cur.left), fr.extend(t, cur.right), 0});
+                }
+                continue;
+            }
+
+            auto push = [&](int c) {
+                int cost = Alpha::mismatch(static_cast<Sym>(c), target);
+                if (cost > cur.errs) {
+                    return;
+                }
+                size_t nl = fr.extend(c, cur.left);
+                size_t nr = fr.extend(c, cur.right);
+                if (nl < nr) {
+                    stk.push_back({cur.idx - 1, nl, nr, cur.errs - cost});
+                }
+            };
+
+            // 좁은 구간은 BWT에 실제로 있는 심볼만, 넓은 구간은 모든 심볼 확장
+            if (cur.right - cur.left <= SCAN_ROWS) {
+                int seen[SCAN_ROWS];
+                size_t n_seen = 0;
+                for (size_t i = cur.left; i < cur.right; i++) {
+                    int c = fr.symbol(i);
+                    if (c != 0 && find(seen, seen + n_seen, c) == seen + n_seen) {
+                        seen[n_seen++] = c;
+                    }
+                }
+                sort(seen, seen + n_seen);
+                for (size_t j = 0; j < n_seen; j++) {
+                    push(seen[j]);
+                }
+            } else {
+                for (size_t c = 1; c < Alpha::SIGMA; c++) {
+                    push(static_cast<int>(c));
+                }
+            }
+        }
+    }
+};
+
+#endif // FMINDEX_HPP
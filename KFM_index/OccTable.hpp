@@ -0,0 +1,187 @@
+#ifndef OCCTABLE_HPP
+#define OCCTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CodeUtil.hpp"
+#include "Storage.hpp"
+
+namespace occ {
+
+// 2bit 필드 합 두 개(각 필드 3 이하)의 전체 합
+inline unsigned field_sum(uint64_t a, uint64_t b) {
+    uint64_t x = (a & 0x3333333333333333ULL) + ((a >> 2) & 0x3333333333333333ULL)
+               + (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+    x = (x & 0x0F0F0F0F0F0F0F0FULL) + ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+}
+
+// 2bit 워드에서 심볼 c(0~3)와 일치하는 칸 마스크 (각 칸의 하위 bit)
+inline uint64_t match_mask(uint64_t word, unsigned c) {
+    uint64_t x = word ^ (0x5555555555555555ULL * c);
+    return ~(x | (x >> 1)) & 0x5555555555555555ULL;
+}
+
+constexpr size_t WORDS_PER_BLOCK = 6;                     // 블록당 2bit 워드 수
+constexpr size_t BASES_PER_WORD  = 32;                    // 워드당 염기 수
+constexpr size_t BLOCK_BASES     = WORDS_PER_BLOCK * BASES_PER_WORD; // 블록당 염기 수 (192)
+constexpr size_t SUPER_BLOCKS    = size_t(1) << 20;       // 상위 블록당 블록 수 (2억 염기, 32bit 누적 수 한계 안)
+
+// 캐시 라인 블록: 상위 블록 시작부터 이 블록 시작까지의 A,C,G,T 누적 수 + 2bit 팩킹 BWT
+struct alignas(64) Block {
+    uint32_t counts[4];
+    uint64_t words[WORDS_PER_BLOCK];
+};
+static_assert(sizeof(Block) == 64, "Block must fill one cache line");
+
+// 블록 랭크 사전: 심볼 인덱스 0 = '$', 1~4 = A,C,G,T
+// 상위 블록마다 64bit 누적 수를 두어 2^32 염기 이상에서도 넘치지 않음 (상위 표는 작아서 캐시에 상주)
+class OccTable {
+public:
+    OccTable() = default;
+
+    // 4bit 팩킹 BWT로부터 구축
+    void build(const std::vector<uint8_t>& bwt_packed, size_t length) {
+        sent_pos = length;
+        std::vector<Block> blocks(length / BLOCK_BASES + 1, Block{});
+        std::vector<uint64_t> supers;
+
+        uint64_t acc[4] = {0, 0, 0, 0};
+        // 블록 b 시작: 상위 블록 시작이면 64bit 누적 수 기록, 블록에는 상대 누적 수
+        auto start_block = [&](size_t b) {
+            if (b % SUPER_BLOCKS == 0) {
+                supers.insert(supers.end(), acc, acc + 4);
+            }
+            const uint64_t* base = &supers[(b / SUPER_BLOCKS) * 4];
+            for (int c = 0; c < 4; c++) {
+                blocks[b].counts[c] = static_cast<uint32_t>(acc[c] - base[c]);
+            }
+        };
+        for (size_t i = 0; i < length; i++) {
+            Block& blk = blocks[i / BLOCK_BASES];
+            size_t r = i % BLOCK_BASES;
+            if (r == 0) {
+                start_block(i / BLOCK_BASES);
+            }
+
+            uint8_t byte = bwt_packed[i >> 1];
+            uint8_t code_val = (i & 1) ? (byte & 0x0F) : (byte >> 4);
+            int k = code::code_to_idx(code_val);
+            if (k == 0) {
+                sent_pos = i; // 센티넬은 A 자리에 두고 위치만 기록
+                continue;
+            }
+            blk.words[r / BASES_PER_WORD] |=
+                static_cast<uint64_t>(k - 1) << (2 * (r % BASES_PER_WORD));
+            acc[k - 1]++;
+        }
+        if (length % BLOCK_BASES == 0) {
+            start_block(blocks.size() - 1);
+        }
+        this->blocks = std::move(blocks);
+        this->supers = std::move(supers);
+    }
+
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(sent_pos));
+        w.put_array(blocks);
+        w.put_array(supers);
+    }
+
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        sent_pos = static_cast<size_t>(r.get<uint64_t>());
+        r.get_array(blocks);
+        r.get_array(supers);
+    }
+
+    // bwt[0, i) 구간의 심볼 k 개수
+    inline size_t rank(int k, size_t i) const {
+        if (k == 0) {
+            return (i > sent_pos) ? 1 : 0;
+        }
+        size_t b = i / BLOCK_BASES;
+        const Block& blk = blocks[b];
+        size_t r = i % BLOCK_BASES;
+        unsigned c = static_cast<unsigned>(k - 1);
+        size_t cnt = supers[(b / SUPER_BLOCKS) * 4 + c] + blk.counts[c];
+
+        // 일치 마스크를 워드 3개씩 2bit 필드 단위로 더한 뒤 한 번에 합산
+        uint64_t sums[2] = {0, 0};
+        size_t w = 0;
+        for (; w < r / BASES_PER_WORD; w++) {
+            sums[w / 3] += match_mask(blk.words[w], c);
+        }
+        size_t rem = r % BASES_PER_WORD;
+        if (rem) {
+            uint64_t mask = (1ULL << (2 * rem)) - 1;
+            sums[w / 3] += match_mask(blk.words[w], c) & mask;
+        }
+        cnt += field_sum(sums[0], sums[1]);
+
+        // 센티넬이 A로 저장되어 있으므로 보정
+        if (c == 0 && sent_pos < i && sent_pos >= i - r) {
+            cnt--;
+        }
+        return cnt;
+    }
+
+    // bwt[0, i) 구간의 모든 심볼 개수를 한 블록 접근으로 계산
+    inline void rank_all(size_t i, size_t out[5]) const {
+        size_t b = i / BLOCK_BASES;
+        const Block& blk = blocks[b];
+        const uint64_t* sup = &supers[(b / SUPER_BLOCKS) * 4];
+        size_t r = i % BLOCK_BASES;
+
+        uint64_t sums[2][4] = {{0, 0, 0, 0}, {0, 0, 0, 0}};
+        size_t full = r / BASES_PER_WORD;
+        size_t rem  = r % BASES_PER_WORD;
+        for (size_t w = 0; w < full + (rem ? 1 : 0); w++) {
+            uint64_t word = blk.words[w];
+            uint64_t mask = (w < full) ? ~0ULL : ((1ULL << (2 * rem)) - 1);
+            for (unsigned c = 0; c < 4; c++) {
+                sums[w / 3][c] += match_mask(word, c) & mask;
+            }
+        }
+        for (unsigned c = 0; c < 4; c++) {
+            out[c + 1] = sup[c] + blk.counts[c] + field_sum(sums[0][c], sums[1][c]);
+        }
+
+        // 센티넬 보정
+        out[0] = (i > sent_pos) ? 1 : 0;
+        if (sent_pos < i && sent_pos >= i - r) {
+            out[1]--;
+        }
+    }
+
+    // bwt[i]의 심볼 인덱스
+    inline int symbol(size_t i) const {
+        if (i == sent_pos) {
+            return 0;
+        }
+        const Block& blk = blocks[i / BLOCK_BASES];
+        size_t r = i % BLOCK_BASES;
+        uint64_t word = blk.words[r / BASES_PER_WORD];
+        return 1 + static_cast<int>((word >> (2 * (r % BASES_PER_WORD))) & 0x3);
+    }
+
+    bool empty() const {
+        return blocks.empty();
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return blocks.bytes() + supers.bytes();
+    }
+
+private:
+    size_t sent_pos = 0;              // 센티넬 위치
+    store::Array<Block> blocks;       // 캐시 라인 블록 배열
+    store::Array<uint64_t> supers;    // 상위 블록별 A,C,G,T 누적 수 (4개씩)
+};
+
+} // namespace occ
+
+#endif // OCCTABLE_HPP
@@ -0,0 +1,77 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <algorithm>
+
+namespace par {
+
+// 기본 스레드 수
+inline size_t default_threads() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+// 동적 스케줄링 병렬 루프: 각 스레드가 chunk 단위로 다음 구간을 가져감
+// fn(i, tid) 는 i 마다 한 번 호출되며 tid 는 0 ~ threads-1
+template <typename Fn>
+void parallel_for(size_t n, size_t threads, size_t chunk, Fn&& fn) {
+    if (chunk == 0) {
+        chunk = 1;
+    }
+    threads = std::max<size_t>(1, std::min(threads, (n + chunk - 1) / chunk));
+    if (threads == 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mtx;
+
+    auto worker = [&](size_t tid) {
+        try {
+            while (true) {
+                size_t begin = next.fetch_add(chunk);
+                if (begin >= n) {
+                    break;
+                }
+                size_t end = std::min(n, begin + chunk);
+                for (size_t i = begin; i < end; i++) {
+                    fn(i, tid);
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mtx);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(n); // 나머지 작업 중단
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace par
+
+#endif // PARALLEL_HPP
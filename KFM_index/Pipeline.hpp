@@ -0,0 +1,125 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+namespace stream {
+
+// 고정 용량 블로킹 큐: 생산자가 앞서가면 대기하여 메모리를 용량으로 제한
+// 항목은 생성 때 잡은 고리 버퍼에 두므로 넣고 꺼낼 때 할당하지 않음
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : cap(capacity ? capacity : 1), items(cap) {}
+
+    // 넣기: 가득 차면 대기, 닫힌 큐면 false
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [&] { return closed || count < cap; });
+        if (closed) {
+            return false;
+        }
+        put(std::move(item));
+        return true;
+    }
+
+    // 대기 없이 넣기: 가득 찼거나 닫혔으면 false (item은 그대로)
+    bool try_push(T& item) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (closed || count == cap) {
+            return false;
+        }
+        put(std::move(item));
+        return true;
+    }
+
+    // 꺼내기: 비어 있으면 대기, 닫히고 비었으면 false
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [&] { return closed || count > 0; });
+        if (count == 0) {
+            return false;
+        }
+        take(item);
+        return true;
+    }
+
+    // 대기 없이 꺼내기: 비어 있으면 false
+    bool try_pop(T& item) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (count == 0) {
+            return false;
+        }
+        take(item);
+        return true;
+    }
+
+    // 닫기: 남은 항목은 꺼낼 수 있고 새 항목은 거부
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    size_t cap;
+    bool closed = false;
+    std::vector<T> items; // 고리 버퍼: [head, head + count)
+    size_t head = 0;
+    size_t count = 0;
+    std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    // 잠금을 잡은 상태에서 맨 뒤에 넣음
+    void put(T&& item) {
+        items[(head + count) % cap] = std::move(item);
+        count++;
+        not_empty.notify_one();
+    }
+
+    // 잠금을 잡은 상태에서 맨 앞을 꺼냄
+    void take(T& item) {
+        item = std::move(items[head]);
+        head = (head + 1) % cap;
+        count--;
+        not_full.notify_one();
+    }
+};
+
+// 단계별 작업/대기 시간 (여러 스레드 합산)
+struct StageTime {
+    std::atomic<long long> busy_us{0};
+    std::atomic<long long> idle_us{0};
+};
+
+// 구간 시간 측정: lap() 호출 사이 경과 시간을 busy 또는 idle에 더함
+class StageClock {
+public:
+    explicit StageClock(StageTime& t) : time(t), last(std::chrono::steady_clock::now()) {}
+
+    void busy() { time.busy_us += lap(); }
+    void idle() { time.idle_us += lap(); }
+
+private:
+    StageTime& time;
+    std::chrono::steady_clock::time_point last;
+
+    long long lap() {
+        auto now = std::chrono::steady_clock::now();
+        long long us = std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+        last = now;
+        return us;
+    }
+};
+
+} // namespace stream
+
+#endif // PIPELINE_HPP
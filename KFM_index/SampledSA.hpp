@@ -0,0 +1,119 @@
+#ifndef SAMPLEDSA_HPP
+#define SAMPLEDSA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include <utility>
+#include "Storage.hpp"
+
+namespace suffix {
+
+// 64비트 popcount
+inline unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 텍스트 위치 기준 샘플링 SA: SA[i] % rate == 0 인 행만 저장
+class SampledSA {
+public:
+    SampledSA() = default;
+
+    // 전체 SA로부터 샘플 구축 (rate 1이면 그대로 보관)
+    void build(std::vector<size_t> sa, size_t sample_rate) {
+        if (sample_rate == 0) {
+            throw std::invalid_argument("SampledSA: sample rate must be positive");
+        }
+        rate_ = sample_rate;
+        marks.clear();
+        mark_rank.clear();
+
+        // 전체 저장
+        if (rate_ == 1) {
+            samples = std::move(sa);
+            return;
+        }
+
+        size_t n = sa.size();
+        std::vector<size_t>   smp;
+        std::vector<uint64_t> mk(n / 64 + 1, 0);
+        std::vector<size_t>   mr(n / 64 + 1, 0);
+        smp.reserve(n / rate_ + 1);
+        for (size_t i = 0; i < n; i++) {
+            if (i % 64 == 0) {
+                mr[i / 64] = smp.size();
+            }
+            if (sa[i] % rate_ == 0) {
+                mk[i / 64] |= 1ULL << (i % 64);
+                smp.push_back(sa[i]);
+            }
+        }
+        if (n % 64 == 0) {
+            mr.back() = smp.size();
+        }
+        samples   = std::move(smp);
+        marks     = std::move(mk);
+        mark_rank = std::move(mr);
+    }
+
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put(static_cast<uint64_t>(rate_));
+        w.put_array(samples);
+        w.put_array(marks);
+        w.put_array(mark_rank);
+    }
+
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        rate_ = static_cast<size_t>(r.get<uint64_t>());
+        if (rate_ == 0) {
+            throw std::runtime_error("SampledSA: invalid sample rate in index file");
+        }
+        r.get_array(samples);
+        r.get_array(marks);
+        r.get_array(mark_rank);
+    }
+
+    // 행 row의 SA 값: 샘플이 나올 때까지 LF 이동
+    template <typename LFStep>
+    inline size_t lookup(size_t row, LFStep&& lf) const {
+        if (rate_ == 1) {
+            return samples[row];
+        }
+        size_t steps = 0;
+        while (!(marks[row / 64] >> (row % 64) & 1)) {
+            row = lf(row);
+            steps++;
+        }
+        uint64_t below = marks[row / 64] & ((1ULL << (row % 64)) - 1);
+        return samples[mark_rank[row / 64] + popcount64(below)] + steps;
+    }
+
+    size_t rate() const {
+        return rate_;
+    }
+
+    // 메모리 사용량 (바이트)
+    size_t bytes() const {
+        return samples.bytes() + marks.bytes() + mark_rank.bytes();
+    }
+
+private:
+    size_t rate_ = 1;               // 샘플링 간격
+    store::Array<size_t> samples;    // 샘플된 SA 값 (행 순서)
+    store::Array<uint64_t> marks;    // 샘플 행 표시 bitvector
+    store::Array<size_t> mark_rank;  // 64행 단위 누적 샘플 수
+};
+
+} // namespace suffix
+
+#endif // SAMPLEDSA_HPP
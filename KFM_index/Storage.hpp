@@ -0,0 +1,175 @@
+#ifndef STORAGE_HPP
+#define STORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace store {
+
+// 섹션 정렬 단위 (캐시 라인)
+constexpr size_t ALIGN = 64;
+
+// FNV-1a 64bit 체크섬
+inline uint64_t checksum(const std::string& data) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// 읽기 전용 배열: 구축 시에는 벡터를 소유, 로드 시에는 매핑 메모리를 가리킴
+template <typename T>
+class Array {
+public:
+    Array() = default;
+    Array(const Array&) = delete;
+    Array& operator=(const Array&) = delete;
+    Array(Array&&) = default;
+    Array& operator=(Array&&) = default;
+
+    Array& operator=(std::vector<T>&& v) {
+        owned = std::move(v);
+        ptr = owned.data();
+        n = owned.size();
+        return *this;
+    }
+
+    // 외부 메모리 참조
+    void view(const T* p, size_t count) {
+        std::vector<T>().swap(owned);
+        ptr = p;
+        n = count;
+    }
+
+    void clear() {
+        std::vector<T>().swap(owned);
+        ptr = nullptr;
+        n = 0;
+    }
+
+    inline const T& operator[](size_t i) const { return ptr[i]; }
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + n; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    size_t bytes() const { return n * sizeof(T); }
+
+private:
+    std::vector<T> owned;
+    const T* ptr = nullptr;
+    size_t n = 0;
+};
+
+// 인덱스 파일 쓰기
+class Writer {
+public:
+    explicit Writer(const std::string& path) : ofs(path, std::ios::binary), path_(path) {
+        if (!ofs) {
+            throw std::runtime_error("open fail: " + path);
+        }
+    }
+
+    // POD 값 쓰기
+    template <typename T>
+    void put(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "put requires POD");
+        write(&v, sizeof(T));
+    }
+
+    // 배열 쓰기: 원소 수 + 정렬 패딩 + 데이터
+    template <typename T>
+    void put_array(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "put_array requires POD");
+        put(static_cast<uint64_t>(count));
+        pad();
+        write(data, count * sizeof(T));
+    }
+
+    template <typename T>
+    void put_array(const Array<T>& arr) {
+        put_array(arr.data(), arr.size());
+    }
+
+    void finish() {
+        ofs.flush();
+        if (!ofs) {
+            throw std::runtime_error("write fail: " + path_);
+        }
+    }
+
+private:
+    std::ofstream ofs;
+    std::string path_;
+    size_t offset = 0;
+
+    void write(const void* p, size_t bytes) {
+        if (bytes) {
+            ofs.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes));
+        }
+        offset += bytes;
+    }
+
+    void pad() {
+        static const char zeros[ALIGN] = {};
+        size_t rem = offset % ALIGN;
+        if (rem) {
+            write(zeros, ALIGN - rem);
+        }
+    }
+};
+
+// 매핑된 인덱스 파일 읽기
+class Reader {
+public:
+    Reader(const char* data, size_t size) : base(data), len(size) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "get requires POD");
+        T v;
+        std::memcpy(&v, take(sizeof(T)), sizeof(T));
+        return v;
+    }
+
+    // 배열을 복사 없이 매핑 메모리로 참조
+    template <typename T>
+    void get_array(Array<T>& arr) {
+        size_t count = static_cast<size_t>(get<uint64_t>());
+        size_t rem = offset % ALIGN;
+        if (rem) {
+            take(ALIGN - rem);
+        }
+        if (count > (len - offset) / sizeof(T)) {
+            throw std::runtime_error("index file truncated");
+        }
+        arr.view(reinterpret_cast<const T*>(take(count * sizeof(T))), count);
+    }
+
+private:
+    const char* base;
+    size_t len;
+    size_t offset = 0;
+
+    const char* take(size_t bytes) {
+        if (bytes > len - offset) {
+            throw std::runtime_error("index file truncated");
+        }
+        const char* p = base + offset;
+        offset += bytes;
+        return p;
+    }
+};
+
+} // namespace store
+
+#endif // STORAGE_HPP
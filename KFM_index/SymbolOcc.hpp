@@ -0,0 +1,145 @@
+#ifndef SYMBOLOCC_HPP
+#define SYMBOLOCC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "CodeUtil.hpp"
+#include "Storage.hpp"
+#include "OccTable.hpp"
+
+namespace occ {
+
+// 블록 랭크 사전: 65536행마다 64bit 누적 수, STEP행 블록마다 16bit 상대 누적 수와
+// 블록의 BWT 심볼을 함께 두어 랭크 한 번에 인접한 메모리만 읽음
+template <typename Sym, std::size_t SIGMA, std::size_t STEP>
+class BlockedOcc {
+public:
+    static constexpr std::size_t SUPER_ROWS = 65536;
+    static_assert(SUPER_ROWS % STEP == 0, "STEP must divide the superblock size");
+
+    struct Block {
+        uint16_t counts[SIGMA]; // 상위 블록 시작부터 이 블록 시작까지의 누적 수
+        Sym      syms[STEP];    // BWT 심볼
+    };
+
+    BlockedOcc() = default;
+
+    // 심볼 BWT로부터 구축
+    void build(const std::vector<Sym>& bwt) {
+        std::size_t n = bwt.size();
+        std::vector<uint64_t> sup((n / SUPER_ROWS + 1) * SIGMA, 0);
+        std::vector<Block>    blk(n / STEP + 1, Block{});
+        std::vector<uint64_t> acc(SIGMA, 0);
+        std::vector<uint64_t> base(SIGMA, 0);
+        for (std::size_t i = 0; i <= n; i++) {
+            if (i % SUPER_ROWS == 0) {
+                std::copy(acc.begin(), acc.end(), sup.begin() + (i / SUPER_ROWS) * SIGMA);
+                base = acc;
+            }
+            if (i % STEP == 0) {
+                for (std::size_t c = 0; c < SIGMA; c++) {
+                    blk[i / STEP].counts[c] = static_cast<uint16_t>(acc[c] - base[c]);
+                }
+            }
+            if (i == n) {
+                break;
+            }
+            blk[i / STEP].syms[i % STEP] = bwt[i];
+            acc[bwt[i]]++;
+        }
+        supers = std::move(sup);
+        blocks = std::move(blk);
+    }
+
+    // 파일 저장
+    void save(store::Writer& w) const {
+        w.put_array(supers);
+        w.put_array(blocks);
+    }
+
+    // 매핑 메모리에서 로드
+    void load(store::Reader& r) {
+        r.get_array(supers);
+        r.get_array(blocks);
+    }
+
+    // bwt[0, i) 구간의 심볼 c 개수
+    inline std::size_t rank(int c, std::size_t i) const {
+        const Block& b = blocks[i / STEP];
+        std::size_t cnt = supers[(i / SUPER_ROWS) * SIGMA + static_cast<std::size_t>(c)] + b.counts[c];
+        // 고정 길이 루프로 두어 컴파일러가 벡터화할 수 있게 함
+        unsigned r = static_cast<unsigned>(i % STEP);
+        unsigned hit = 0;
+        for (unsigned j = 0; j < STEP; j++) {
+            hit += (b.syms[j] == c) & (j < r);
+        }
+        return cnt + hit;
+    }
+
+    // bwt[i]의 심볼
+    inline int symbol(std::size_t i) const {
+        return blocks[i / STEP].syms[i % STEP];
+    }
+
+    // 메모리 사용량 (바이트)
+    std::size_t bytes() const {
+        return supers.bytes() + blocks.bytes();
+    }
+
+private:
+    store::Array<uint64_t> supers; // (행 수 / 65536 + 1) x SIGMA 누적 수
+    store::Array<Block>    blocks; // 블록 상대 누적 수 + 심볼
+};
+
+// 1염기 심볼: cfmindex와 같은 2bit 캐시 라인 블록 랭크 사전
+class NibbleOcc {
+public:
+    NibbleOcc() = default;
+
+    // 심볼(0 = '$', 1~4 = A,C,G,T) BWT를 4bit 코드로 팩킹하여 구축
+    void build(const std::vector<uint8_t>& bwt) {
+        static const uint8_t CODES[5] = {code::SENT_CODE, 0x1, 0x5, 0x9, 0xD};
+        std::vector<uint8_t> packed((bwt.size() + 1) / 2, 0);
+        for (std::size_t i = 0; i < bwt.size(); i++) {
+            uint8_t c = CODES[bwt[i]];
+            packed[i >> 1] |= static_cast<uint8_t>((i & 1) ? c : (c << 4));
+        }
+        table.build(packed, bwt.size());
+    }
+
+    void save(store::Writer& w) const {
+        table.save(w);
+    }
+
+    void load(store::Reader& r) {
+        table.load(r);
+    }
+
+    inline std::size_t rank(int c, std::size_t i) const {
+        return table.rank(c, i);
+    }
+
+    inline int symbol(std::size_t i) const {
+        return table.symbol(i);
+    }
+
+    std::size_t bytes() const {
+        return table.bytes();
+    }
+
+private:
+    OccTable table;
+};
+
+// K별 랭크 사전 선택: 블록 크기가 염기당 약 2.5 bytes 이하가 되도록 STEP 결정
+template <std::size_t K> struct OccFor;
+template <> struct OccFor<1> { using type = NibbleOcc; };
+template <> struct OccFor<2> { using type = BlockedOcc<uint8_t,  17,  32>; };
+template <> struct OccFor<3> { using type = BlockedOcc<uint8_t,  65,  32>; };
+template <> struct OccFor<4> { using type = BlockedOcc<uint16_t, 257, 64>; };
+
+} // namespace occ
+
+#endif // SYMBOLOCC_HPP
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Storage.hpp"
+#include "FMIndex.hpp"
+
+using namespace std;
+using namespace chrono;
+
+// 레퍼런스로 FM-index를 구축하여 파일로 저장
+int main(int argc, char* argv[]) {
+    const string ref_path = "reference.txt"; // 레퍼런스 파일
+
+    opt::Options opts;
+    try {
+        opts = opt::parse_options(argc, argv);
+        // 인덱스 내용을 정하는 옵션만 받음
+        opt::reject_unused(opts, {"--sa-rate", "--index", "--bases"}, "build_index");
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    size_t bases = opts.bases;
+    const string idx_path = opts.index_path.empty() ? "kfmindex.idx" : opts.index_path;
+
+    try {
+        string reference = io::read_reference(ref_path);
+
+        auto t_s = high_resolution_clock::now();
+        uint64_t sum = store::checksum(reference);
+        switch (bases) {
+            case 1:  FMIndex<1>(reference, opts.sa_rate).save(idx_path, sum); break;
+            case 2:  FMIndex<2>(reference, opts.sa_rate).save(idx_path, sum); break;
+            case 3:  FMIndex<3>(reference, opts.sa_rate).save(idx_path, sum); break;
+            default: FMIndex<4>(reference, opts.sa_rate).save(idx_path, sum); break;
+        }
+        auto t_e = high_resolution_clock::now();
+
+        cout << "Index written: " << idx_path << " ("
+             << duration_cast<milliseconds>(t_e - t_s).count() << " ms)\n";
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
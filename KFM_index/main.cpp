@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "Assemble.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    const string ref_path  = "reference.txt";          // 레퍼런스 파일
+    const string read_path = "reads.txt";              // 리드 파일
+    const string out_path  = "kfmindex_assembled.txt"; // 결과 출력 파일
+
+    // 명령행 옵션
+    opt::Options opts;
+    try {
+        opts = opt::parse_options(argc, argv);
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    size_t bases = opts.bases;
+
+    // 사용자 입력
+    int max_err = 0;
+    cout << "Enter max mismatch (D): ";
+    if (!(cin >> max_err) || max_err < 0) {
+        cerr << "Invalid integer.\n";
+        return 1;
+    }
+
+    try {
+        // 입력 로드
+        string reference = io::read_reference(ref_path);
+
+        // 어셈블 호출: 리드는 파이프라인에서 배치 단위로 읽음
+        string assembled;
+        switch (bases) {
+            case 1:  assembled = assemble_reads<1>(reference, read_path, max_err, opts); break;
+            case 2:  assembled = assemble_reads<2>(reference, read_path, max_err, opts); break;
+            case 3:  assembled = assemble_reads<3>(reference, read_path, max_err, opts); break;
+            default: assembled = assemble_reads<4>(reference, read_path, max_err, opts); break;
+        }
+
+        // 결과 저장
+        io::write_text(out_path, assembled);
+        cout << "Assembly finished. Output: " << out_path << "\n";
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
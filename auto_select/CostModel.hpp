@@ -0,0 +1,292 @@
+#ifndef COSTMODEL_HPP
+#define COSTMODEL_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace cost {
+
+// 선택 대상 엔진 (실행 파일, 타이밍/결과 파일 이름의 접두사)
+static const array<string, 3> ENGINES = {"linear", "cfmindex", "2fmindex"};
+
+// 작업 크기
+struct Workload {
+    double n;      // 레퍼런스 길이 N
+    double reads;  // 리드 수
+    double len;    // 리드 길이 L
+    int    d;      // 허용 mismatch 수 D
+};
+
+// 측정 한 건: 작업 크기와 엔진의 Total pipeline time
+struct Sample {
+    Workload w;
+    double   ms;
+};
+
+// 엔진별 비용 특징값
+// linear : 1, N x 리드 수 x (D+1)   (위치마다 최대 D+1개 mismatch까지 비교)
+// FM 계열: 1, N (구축 + 투표), 리드 수 x L (파싱, 정확 일치 단계),
+//          리드 수 x log2(N)^D, 리드 수 x L x log2(N)^D (mismatch 가지 수)
+inline vector<double> features(const string& engine, const Workload& w) {
+    if (engine == "linear") {
+        return {1.0, w.n * w.reads * (w.d + 1)};
+    }
+    double branch = pow(log2(max(w.n, 2.0)), w.d);
+    return {1.0, w.n, w.reads * w.len, w.reads * branch, w.reads * w.len * branch};
+}
+
+// 가중 최소제곱: 가중치 1/ms로 상대 오차를 최소화, 음수 계수가 나오면 그 특징을 빼고 다시 풂
+inline vector<double> fit(const vector<vector<double>>& x, const vector<double>& y) {
+    size_t k = x.empty() ? 0 : x[0].size();
+    vector<bool> active(k, true);
+
+    while (true) {
+        vector<size_t> cols;
+        for (size_t j = 0; j < k; j++) {
+            if (active[j]) cols.push_back(j);
+        }
+        size_t m = cols.size();
+        vector<double> coef(k, 0.0);
+        if (m == 0) {
+            return coef;
+        }
+
+        // 열 크기를 맞춘 뒤 정규방정식 구성
+        vector<double> scale(m, 0.0);
+        for (size_t i = 0; i < x.size(); i++) {
+            for (size_t a = 0; a < m; a++) {
+                scale[a] = max(scale[a], fabs(x[i][cols[a]] / y[i]));
+            }
+        }
+        vector<vector<double>> ata(m, vector<double>(m + 1, 0.0));
+        for (size_t i = 0; i < x.size(); i++) {
+            double wgt = 1.0 / y[i];
+            for (size_t a = 0; a < m; a++) {
+                double xa = scale[a] > 0 ? x[i][cols[a]] * wgt / scale[a] : 0.0;
+                for (size_t b = 0; b < m; b++) {
+                    double xb = scale[b] > 0 ? x[i][cols[b]] * wgt / scale[b] : 0.0;
+                    ata[a][b] += xa * xb;
+                }
+                ata[a][m] += xa * (y[i] * wgt);
+            }
+        }
+        for (size_t a = 0; a < m; a++) {
+            ata[a][a] += 1e-9; // 특징이 겹칠 때를 위한 작은 릿지
+        }
+
+        // 가우스 소거 (부분 피벗)
+        for (size_t p = 0; p < m; p++) {
+            size_t piv = p;
+            for (size_t r = p + 1; r < m; r++) {
+                if (fabs(ata[r][p]) > fabs(ata[piv][p])) piv = r;
+            }
+            swap(ata[p], ata[piv]);
+            for (size_t r = 0; r < m; r++) {
+                if (r == p || ata[p][p] == 0.0) continue;
+                double f = ata[r][p] / ata[p][p];
+                for (size_t c = p; c <= m; c++) {
+                    ata[r][c] -= f * ata[p][c];
+                }
+            }
+        }
+
+        size_t worst = k;
+        double worst_val = 0.0;
+        for (size_t a = 0; a < m; a++) {
+            double v = (ata[a][a] != 0.0 ? ata[a][m] / ata[a][a] : 0.0);
+            v = scale[a] > 0 ? v / scale[a] : 0.0;
+            coef[cols[a]] = v;
+            if (v < worst_val) {
+                worst_val = v;
+                worst = cols[a];
+            }
+        }
+        if (worst == k) {
+            return coef;
+        }
+        active[worst] = false;
+    }
+}
+
+// 벤치마크 CSV(N,L,R,D,<엔진>_time,...)로 보정한 엔진별, D별 비용 모델
+class CostModel {
+public:
+    // CSV 한 파일의 측정값 추가: 리드 수는 read_create와 같이 R x N / L
+    void add_csv(const string& path) {
+        ifstream ifs(path);
+        if (!ifs) {
+            throw runtime_error("open fail: " + path);
+        }
+        string line;
+        if (!getline(ifs, line)) {
+            return;
+        }
+        vector<string> header = split(line);
+        auto col = [&](const string& name) -> int {
+            auto it = find(header.begin(), header.end(), name);
+            return it == header.end() ? -1 : static_cast<int>(it - header.begin());
+        };
+        int cn = col("N"), cl = col("L"), cr = col("R"), cd = col("D");
+        if (cn < 0 || cl < 0 || cd < 0) {
+            throw runtime_error("missing N, L or D column: " + path);
+        }
+
+        while (getline(ifs, line)) {
+            vector<string> f = split(line);
+            if (f.size() < header.size()) continue;
+            Workload w;
+            w.n   = stod(f[cn]);
+            w.len = stod(f[cl]);
+            w.d   = stoi(f[cd]);
+            // R 열이 없으면 노트북과 같이 R = 18750 / (N / L)
+            double r = (cr >= 0) ? stod(f[cr]) : floor(18750.0 / (w.n / w.len));
+            w.reads = r * floor(w.n / w.len);
+            for (const string& eng : ENGINES) {
+                int ct = col(eng + "_time");
+                if (ct < 0 || f[ct].empty()) continue;
+                samples[eng].push_back({w, max(stod(f[ct]), 1.0)});
+            }
+        }
+        sources++;
+    }
+
+    // 엔진별, D별로 계수 보정 (linear는 D를 특징에 넣어 한 모델로 보정)
+    void calibrate() {
+        coefs.clear();
+        for (const auto& kv : samples) {
+            const string& eng = kv.first;
+            map<int, vector<const Sample*>> groups;
+            for (const Sample& s : kv.second) {
+                groups[eng == "linear" ? 0 : s.w.d].push_back(&s);
+            }
+            for (const auto& g : groups) {
+                vector<vector<double>> x;
+                vector<double> y;
+                for (const Sample* s : g.second) {
+                    x.push_back(features(eng, s->w));
+                    y.push_back(s->ms);
+                }
+                coefs[eng][g.first] = fit(x, y);
+            }
+        }
+    }
+
+    // 엔진 예측 시간 (ms), 보정 자료가 없으면 음수
+    // 보정된 D가 없으면 가장 가까운 D의 모델로 그 D의 시간을 구한 뒤, 가까운 두 보정 D 사이의
+    // D 한 단계당 증가율(MAX_STEP_RATIO로 제한)을 D 차이만큼 곱하고 extrapolated 표시
+    // 보정된 D가 하나뿐이라 증가율을 모르면 음수 (extrapolated 표시로 자료 없음과 구분)
+    double predict(const string& engine, const Workload& w, bool* extrapolated = nullptr) const {
+        auto it = coefs.find(engine);
+        if (it == coefs.end() || it->second.empty()) {
+            return -1.0;
+        }
+        const map<int, vector<double>>& by_d = it->second;
+        int key = (engine == "linear") ? 0 : nearest_d(by_d, w.d);
+        bool extra = engine != "linear" && key != w.d;
+        if (extrapolated) {
+            *extrapolated = extra;
+        }
+        if (!extra) {
+            return eval(engine, by_d.at(key), w);
+        }
+        if (by_d.size() < 2) {
+            return -1.0;
+        }
+
+        // 증가율: 요청한 D에 가장 가까운 두 보정 D에서 같은 작업 크기의 예측 비
+        vector<int> ds;
+        for (const auto& kv : by_d) {
+            ds.push_back(kv.first);
+        }
+        sort(ds.begin(), ds.end(), [&](int a, int b) {
+            return abs(a - w.d) != abs(b - w.d) ? abs(a - w.d) < abs(b - w.d) : a < b;
+        });
+        int lo = min(ds[0], ds[1]), hi = max(ds[0], ds[1]);
+        double t_lo = eval(engine, by_d.at(lo), at_d(w, lo));
+        double t_hi = eval(engine, by_d.at(hi), at_d(w, hi));
+        double step = (t_lo > 0.0 && t_hi > 0.0) ? pow(t_hi / t_lo, 1.0 / (hi - lo)) : MAX_STEP_RATIO;
+        step = min(max(step, 1.0), MAX_STEP_RATIO);
+        return eval(engine, by_d.at(key), at_d(w, key)) * pow(step, w.d - key);
+    }
+
+    // 보정 자료의 중앙 상대 오차 (%), 자료가 없으면 음수
+    double median_error(const string& engine) const {
+        auto it = samples.find(engine);
+        if (it == samples.end() || it->second.empty()) {
+            return -1.0;
+        }
+        vector<double> err;
+        for (const Sample& s : it->second) {
+            err.push_back(fabs(predict(engine, s.w) - s.ms) / s.ms * 100.0);
+        }
+        nth_element(err.begin(), err.begin() + err.size() / 2, err.end());
+        return err[err.size() / 2];
+    }
+
+    size_t sample_count(const string& engine) const {
+        auto it = samples.find(engine);
+        return it == samples.end() ? 0 : it->second.size();
+    }
+
+    size_t source_count() const {
+        return sources;
+    }
+
+private:
+    map<string, vector<Sample>> samples;             // 엔진별 측정값
+    map<string, map<int, vector<double>>> coefs;     // 엔진 -> D -> 계수
+    size_t sources = 0;                              // 읽은 CSV 수
+
+    static vector<string> split(const string& line) {
+        vector<string> out;
+        stringstream ss(line);
+        string cell;
+        while (getline(ss, cell, ',')) {
+            if (!cell.empty() && cell.back() == '\r') cell.pop_back();
+            out.push_back(cell);
+        }
+        if (!line.empty() && line.back() == ',') {
+            out.push_back("");
+        }
+        return out;
+    }
+
+    // 보정 범위 밖 D에서 D 한 단계당 시간 증가율 상한
+    static constexpr double MAX_STEP_RATIO = 8.0;
+
+    static double eval(const string& engine, const vector<double>& c, const Workload& w) {
+        vector<double> f = features(engine, w);
+        double t = 0.0;
+        for (size_t j = 0; j < f.size(); j++) {
+            t += c[j] * f[j];
+        }
+        return t;
+    }
+
+    static Workload at_d(Workload w, int d) {
+        w.d = d;
+        return w;
+    }
+
+    static int nearest_d(const map<int, vector<double>>& by_d, int d) {
+        int best = by_d.begin()->first;
+        for (const auto& kv : by_d) {
+            if (abs(kv.first - d) < abs(best - d)) best = kv.first;
+        }
+        return best;
+    }
+};
+
+} // namespace cost
+
+#endif // COSTMODEL_HPP
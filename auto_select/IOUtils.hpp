@@ -0,0 +1,303 @@
+#ifndef IOUTILS_HPP
+#define IOUTILS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstddef>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IOUTILS_SSE2 1
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace io {
+
+// 참조 읽기
+inline string read_reference(const string& path) {
+
+    ifstream ifs(path);
+    if (!ifs) {
+        throw runtime_error("open fail: " + path);
+    }
+
+    ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+// 리드 읽기
+inline vector<string> read_reads(const string& path) {
+
+    ifstream ifs(path);
+    string line;
+    if (!ifs) {
+        throw runtime_error("open fail: " + path);
+    }
+    if (!getline(ifs, line)) {
+        throw runtime_error("read fail: " + path);
+    }
+
+    vector<string> reads; // 결과 벡터
+    size_t start = 0;
+    while (true) {
+        size_t pos = line.find(',', start);
+        if (pos == string::npos) {
+            reads.push_back(line.substr(start));
+            break;
+        }
+        reads.push_back(line.substr(start, pos - start));
+        start = pos + 1;
+    }
+    return reads;
+}
+
+// 텍스트 쓰기
+inline void write_text(const string& path, const string& content) {
+
+    ofstream ofs(path);
+    if (!ofs) {
+        throw runtime_error("open fail: " + path);
+    }
+    
+    ofs << content;
+}
+
+// 파일 존재 여부
+inline bool file_exists(const string& path) {
+    ifstream ifs(path, ios::binary);
+    return static_cast<bool>(ifs);
+}
+
+// 프로세스 최대 상주 메모리 (바이트), 알 수 없으면 0
+inline size_t peak_rss_bytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return 0;
+    }
+    return pmc.PeakWorkingSetSize;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(ru.ru_maxrss);        // macOS는 바이트
+#else
+    return static_cast<size_t>(ru.ru_maxrss) * 1024; // Linux는 KB
+#endif
+#endif
+}
+
+// 읽기 전용 메모리 매핑 파일
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw runtime_error("open fail: " + path);
+        }
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file, &sz)) {
+            close();
+            throw runtime_error("stat fail: " + path);
+        }
+        len = static_cast<size_t>(sz.QuadPart);
+        if (len > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                close();
+                throw runtime_error("mmap fail: " + path);
+            }
+            ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!ptr) {
+                close();
+                throw runtime_error("mmap fail: " + path);
+            }
+        }
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("open fail: " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            throw runtime_error("stat fail: " + path);
+        }
+        len = static_cast<size_t>(st.st_size);
+        if (len > 0) {
+            void* p = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                close();
+                throw runtime_error("mmap fail: " + path);
+            }
+            ptr = static_cast<const char*>(p);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept {
+        swap_with(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap_with(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+
+private:
+    const char* ptr = nullptr;
+    size_t len = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    void swap_with(MappedFile& other) noexcept {
+        std::swap(ptr, other.ptr);
+        std::swap(len, other.len);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (ptr) UnmapViewOfFile(ptr);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (ptr) munmap(const_cast<char*>(ptr), len);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        ptr = nullptr;
+        len = 0;
+    }
+};
+
+// p[0, n)에서 첫 ',' 또는 '\n' 위치 (없으면 n)
+inline size_t find_delim(const char* p, size_t n) {
+    size_t i = 0;
+#ifdef IOUTILS_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i nl    = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, nl)));
+        if (mask) {
+            while (!(mask & 1)) {
+                mask >>= 1;
+                i++;
+            }
+            return i;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (p[i] == ',' || p[i] == '\n') {
+            return i;
+        }
+    }
+    return n;
+}
+
+// 매핑된 리드 파일을 배치 단위로 분리: 첫 줄을 ','로 나눈 뷰
+class ReadScanner {
+public:
+    ReadScanner(const char* data, size_t size) : p(data), n(size) {}
+
+    // 다음 리드를 최대 max_reads개 out에 채움 (더 없으면 false)
+    bool next(vector<string_view>& out, size_t max_reads) {
+        out.clear();
+        while (!done && out.size() < max_reads) {
+            size_t pos = start + find_delim(p + start, n - start);
+            out.emplace_back(p + start, pos - start);
+            if (pos == n || p[pos] == '\n') {
+                done = true;
+            } else {
+                start = pos + 1;
+            }
+        }
+        return !out.empty();
+    }
+
+private:
+    const char* p;
+    size_t n;
+    size_t start = 0;
+    bool done = false;
+};
+
+// 매핑된 리드 파일: 리드는 파일 내용을 가리키는 뷰
+struct MappedReads {
+    MappedFile file;
+    vector<string_view> reads;
+};
+
+// 리드 파일 매핑 (빈 파일이면 read_reads와 같이 실패)
+inline MappedFile map_read_file(const string& path) {
+    MappedFile file(path);
+    if (file.size() == 0) {
+        throw runtime_error("read fail: " + path);
+    }
+    return file;
+}
+
+// 리드 읽기 (복사 없음): read_reads와 같이 첫 줄을 ','로 분리
+inline MappedReads map_reads(const string& path) {
+    MappedReads res;
+    res.file = map_read_file(path);
+    ReadScanner scanner(res.file.data(), res.file.size());
+    scanner.next(res.reads, static_cast<size_t>(-1));
+    return res;
+}
+
+} // namespace io
+
+#endif // IOUTILS_HPP
\ No newline at end of file
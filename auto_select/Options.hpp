@@ -0,0 +1,75 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+
+namespace opt {
+
+// 실행 옵션
+struct Options {
+    string data_dir = "data"; // 보정용 벤치마크 CSV 디렉터리 (--data)
+    string bin_dir = ".";     // 엔진 실행 파일 디렉터리 (--bin)
+    string engine;            // 모델 대신 고정할 엔진 (--engine)
+    bool dry_run = false;     // 예측과 선택만 기록하고 실행 안 함 (--dry-run)
+    vector<string> engine_args; // '--' 뒤 인자: FM 엔진에 그대로 전달
+};
+
+// 엔진이 '--' 뒤 인자를 받을 수 있는지 (cfmindex는 자체 검사)
+// 2fmindex는 공통 옵션만, linear는 --scan과 --threads만 받음
+inline bool accepts_args(const string& engine, const vector<string>& args) {
+    if (engine == "cfmindex") {
+        return true;
+    }
+    bool linear = (engine == "linear");
+    for (size_t i = 0; i < args.size(); i++) {
+        const string& a = args[i];
+        if (linear ? (a == "--scan" || a == "--threads")
+                   : (a == "--sa-rate" || a == "--threads" || a == "--batch" || a == "--index")) {
+            i++; // 값
+        } else if (linear || a != "--scaling") {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 명령행 옵션 파싱
+inline Options parse_options(int argc, char* argv[]) {
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) {
+                throw invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--data") {
+            opts.data_dir = value();
+        } else if (arg == "--bin") {
+            opts.bin_dir = value();
+        } else if (arg == "--engine") {
+            opts.engine = value();
+            if (opts.engine != "linear" && opts.engine != "cfmindex" && opts.engine != "2fmindex") {
+                throw invalid_argument("--engine must be linear, cfmindex or 2fmindex");
+            }
+        } else if (arg == "--dry-run") {
+            opts.dry_run = true;
+        } else if (arg == "--") {
+            opts.engine_args.assign(argv + i + 1, argv + argc);
+            break;
+        } else {
+            throw invalid_argument("unknown option: " + arg);
+        }
+    }
+    return opts;
+}
+
+} // namespace opt
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,236 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <filesystem>
+#include <algorithm>
+#include "IOUtils.hpp"
+#include "Options.hpp"
+#include "CostModel.hpp"
+
+#ifdef _WIN32
+#define popen  _popen
+#define pclose _pclose
+#endif
+
+using namespace std;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+// 엔진 실행 파일 경로 (노트북과 같은 이름: <엔진>_assemble)
+string engine_path(const string& bin_dir, const string& engine) {
+#ifdef _WIN32
+    const string suffix = ".exe";
+#else
+    const string suffix = "";
+#endif
+    return (fs::path(bin_dir) / (engine + "_assemble" + suffix)).string();
+}
+
+// 엔진 실행: 표준 입력으로 D 전달, 종료 코드 반환
+int run_engine(const string& path, const vector<string>& args, int max_err) {
+    string cmd = "\"" + path + "\"";
+    for (const string& a : args) {
+        cmd += " \"" + a + "\"";
+    }
+#ifdef _WIN32
+    cmd = "\"" + cmd + "\""; // cmd.exe는 바깥 따옴표를 한 겹 벗김
+#endif
+    FILE* pipe = popen(cmd.c_str(), "w");
+    if (!pipe) {
+        throw runtime_error("failed to start: " + path);
+    }
+    fprintf(pipe, "%d\n", max_err);
+    return pclose(pipe);
+}
+
+// 타이밍 파일에서 Total pipeline time (ms) 읽기
+long long parse_total_ms(const string& path) {
+    ifstream ifs(path);
+    string line;
+    while (getline(ifs, line)) {
+        if (line.find("Total pipeline time") != string::npos) {
+            size_t pos = line.find(':');
+            return stoll(line.substr(pos + 1));
+        }
+    }
+    throw runtime_error("Total time not found in " + path);
+}
+
+int main(int argc, char* argv[]) {
+    const string ref_path   = "reference.txt";     // 레퍼런스 파일
+    const string read_path  = "reads.txt";         // 리드 파일
+    const string out_path   = "auto_assembled.txt"; // 결과 출력 파일
+    const string time_path  = "auto_timing.txt";   // 타이밍 파일
+    const string log_path   = "auto_log.csv";      // 실행마다 선택과 예측/실제 시간 누적
+
+    // 명령행 옵션
+    opt::Options opts;
+    try {
+        opts = opt::parse_options(argc, argv);
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // 사용자 입력
+    int max_err = 0;
+    cout << "Enter max mismatch (D): ";
+    if (!(cin >> max_err) || max_err < 0) {
+        cerr << "Invalid integer.\n";
+        return 1;
+    }
+
+    try {
+        auto t_start = high_resolution_clock::now();
+
+        // 작업 크기: 레퍼런스 길이, 리드 수, 평균 리드 길이
+        cost::Workload w;
+        w.n = static_cast<double>(io::read_reference(ref_path).size());
+        w.d = max_err;
+        {
+            io::MappedReads mr = io::map_reads(read_path);
+            size_t cnt = 0, bases = 0;
+            for (string_view r : mr.reads) {
+                if (r.empty()) continue; // 끝의 ',' 뒤 빈 리드
+                cnt++;
+                bases += r.size();
+            }
+            w.reads = static_cast<double>(cnt);
+            w.len = cnt ? static_cast<double>(bases) / cnt : 0.0;
+        }
+
+        // 보정: 데이터 디렉터리의 모든 벤치마크 CSV
+        cost::CostModel model;
+        if (fs::is_directory(opts.data_dir)) {
+            vector<fs::path> csvs;
+            for (const auto& ent : fs::directory_iterator(opts.data_dir)) {
+                if (ent.path().extension() == ".csv") csvs.push_back(ent.path());
+            }
+            sort(csvs.begin(), csvs.end());
+            for (const auto& p : csvs) {
+                model.add_csv(p.string());
+            }
+        }
+        model.calibrate();
+
+        // 엔진별 예측, 가장 싼 엔진 선택
+        vector<double> pred;
+        vector<bool> extra;
+        string chosen = opts.engine;
+        double best = -1.0;
+        for (const string& eng : cost::ENGINES) {
+            bool ex = false;
+            double t = model.predict(eng, w, &ex);
+            pred.push_back(t);
+            extra.push_back(ex);
+            // '--' 뒤 인자를 받지 못하는 엔진은 후보에서 뺌
+            bool usable = opt::accepts_args(eng, opts.engine_args);
+            // 보정된 D가 하나뿐이라 외삽할 수 없는 엔진은 빼고 고르지 않고 엔진 지정을 요구
+            if (opts.engine.empty() && usable && t < 0.0 && ex) {
+                throw runtime_error(eng + " is not calibrated for D=" + to_string(w.d)
+                                    + " and has too few D values to extrapolate (use --engine)");
+            }
+            if (opts.engine.empty() && usable && t >= 0.0 && (best < 0.0 || t < best)) {
+                best = t;
+                chosen = eng;
+            }
+        }
+        if (!opts.engine.empty() && !opt::accepts_args(opts.engine, opts.engine_args)) {
+            throw runtime_error(opts.engine + " does not accept the engine arguments after '--'");
+        }
+        if (chosen.empty()) {
+            throw runtime_error("no calibration data in " + opts.data_dir
+                                + " for an engine that accepts the arguments (use --engine)");
+        }
+        size_t chosen_idx = find(cost::ENGINES.begin(), cost::ENGINES.end(), chosen) - cost::ENGINES.begin();
+        auto t_model = high_resolution_clock::now();
+        long long model_ms = duration_cast<milliseconds>(t_model - t_start).count();
+
+        // 선택한 엔진 실행 (인자는 accepts_args로 확인한 그대로 전달)
+        long long engine_ms = -1;
+        long long run_ms = 0;
+        if (!opts.dry_run) {
+            string path = engine_path(opts.bin_dir, chosen);
+            auto t_run_s = high_resolution_clock::now();
+            int rc = run_engine(path, opts.engine_args, max_err);
+            auto t_run_e = high_resolution_clock::now();
+            run_ms = duration_cast<milliseconds>(t_run_e - t_run_s).count();
+            cout << "\n";
+            if (rc != 0) {
+                throw runtime_error(path + " failed (exit " + to_string(rc) + ")");
+            }
+            engine_ms = parse_total_ms(chosen + "_timing.txt");
+            io::write_text(out_path, io::read_reference(chosen + "_assembled.txt"));
+        }
+        long long total_ms = duration_cast<milliseconds>(high_resolution_clock::now() - t_start).count();
+
+        // 타이밍 로그
+        ofstream tfs(time_path);
+        if (tfs) {
+            tfs << "Workload (N / reads / L / D) : " << static_cast<size_t>(w.n) << " / "
+                << static_cast<size_t>(w.reads) << " / " << w.len << " / " << w.d << "\n";
+            tfs << "Calibration files       : " << model.source_count() << " (" << opts.data_dir << ")\n";
+            for (size_t e = 0; e < cost::ENGINES.size(); e++) {
+                const string& eng = cost::ENGINES[e];
+                tfs << "Predicted " << eng << string(14 - min<size_t>(14, eng.size()), ' ') << ": ";
+                if (pred[e] < 0.0) {
+                    tfs << (extra[e] ? "n/a (D not calibrated)\n" : "n/a (no samples)\n");
+                    continue;
+                }
+                tfs << llround(pred[e]) << " ms (" << model.sample_count(eng) << " samples, median error "
+                    << llround(model.median_error(eng)) << "%" << (extra[e] ? ", D extrapolated" : "")
+                    << (opt::accepts_args(eng, opts.engine_args) ? "" : ", skipped: engine args") << ")\n";
+            }
+            tfs << "Selected engine         : " << chosen << (opts.engine.empty() ? "" : " (forced)") << "\n";
+            tfs << "Model time              : " << model_ms << " ms\n";
+            if (!opts.dry_run) {
+                tfs << "Engine run time         : " << run_ms << " ms\n";
+                tfs << "Engine pipeline time    : " << engine_ms << " ms (predicted "
+                    << llround(pred[chosen_idx]) << " ms)\n";
+            }
+            tfs << "Total pipeline time     : " << total_ms << " ms\n";
+        }
+
+        // 누적 로그: 벤치마크 CSV와 같은 열 이름이라 data 디렉터리에 넣으면 재보정에 쓰임
+        bool fresh = !io::file_exists(log_path);
+        ofstream lfs(log_path, ios::app);
+        if (lfs) {
+            if (fresh) {
+                lfs << "N,L,R,D,engine";
+                for (const string& eng : cost::ENGINES) lfs << "," << eng << "_pred";
+                for (const string& eng : cost::ENGINES) lfs << "," << eng << "_time";
+                lfs << "\n";
+            }
+            double per_pass = floor(w.n / max(w.len, 1.0));
+            lfs << static_cast<size_t>(w.n) << "," << llround(w.len) << ","
+                << (per_pass > 0 ? w.reads / per_pass : 0.0) << "," << w.d << "," << chosen;
+            for (double p : pred) {
+                lfs << ",";
+                if (p >= 0.0) lfs << llround(p);
+            }
+            for (const string& eng : cost::ENGINES) {
+                lfs << ",";
+                if (eng == chosen && engine_ms >= 0) lfs << engine_ms;
+            }
+            lfs << "\n";
+        }
+
+        if (opts.dry_run) {
+            cout << "Selected engine: " << chosen << " (dry run)\n";
+        } else {
+            cout << "Assembly finished with " << chosen << ". Output: " << out_path << "\n";
+        }
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
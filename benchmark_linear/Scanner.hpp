@@ -0,0 +1,351 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "Parallel.hpp"
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SCANNER_AVX2 1
+#endif
+
+using namespace std;
+
+namespace scan {
+
+// 스캐너 종류
+enum class Kind { Scalar, Word, Avx2, Avx512 };
+
+inline const char* kind_name(Kind k) {
+    switch (k) {
+        case Kind::Scalar: return "scalar";
+        case Kind::Word:   return "word";
+        case Kind::Avx2:   return "avx2";
+        case Kind::Avx512: return "avx512";
+    }
+    return "?";
+}
+
+constexpr size_t BLOCK_POS = size_t(1) << 16; // 스레드가 한 번에 맡는 레퍼런스 시작 위치 수 (4의 배수)
+constexpr uint64_t LOW_BITS = 0x5555555555555555ULL; // 2bit 칸마다 하위 bit
+
+// 염기 -> 2bit 값 (A,C,G,T 외에는 -1)
+inline int base_bits(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default:  return -1;
+    }
+}
+
+// 64비트 popcount
+inline unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 2bit 팩킹 서열: i번째 염기는 words[i / 32]의 2*(i % 32) bit부터 (뒤 염기가 상위 bit)
+// 끝에 0 워드 2개를 두어 어느 위치에서든 두 워드를 읽을 수 있음
+struct Packed {
+    vector<uint64_t> words;
+    vector<uint64_t> masks; // 워드별 유효 칸 하위 bit 마스크 (리드용)
+    size_t length = 0;
+
+    // ACGT 외 문자가 있으면 false
+    bool pack(const string& seq) {
+        length = seq.size();
+        size_t n_words = (length + 31) / 32;
+        words.assign(n_words + 2, 0);
+        masks.assign(n_words, LOW_BITS);
+        for (size_t i = 0; i < length; i++) {
+            int b = base_bits(seq[i]);
+            if (b < 0) {
+                return false;
+            }
+            words[i / 32] |= static_cast<uint64_t>(b) << (2 * (i % 32));
+        }
+        if (length % 32) {
+            masks.back() = LOW_BITS & ((1ULL << (2 * (length % 32))) - 1);
+        }
+        return true;
+    }
+};
+
+// 레퍼런스 pos부터 32염기 창 (words[k] 이후 두 워드 사용)
+inline uint64_t window(const uint64_t* ref, size_t pos) {
+    size_t k = pos / 32;
+    unsigned s = static_cast<unsigned>(2 * (pos % 32));
+    uint64_t w = ref[k] >> s;
+    if (s) {
+        w |= ref[k + 1] << (64 - s);
+    }
+    return w;
+}
+
+// 기존 문자 단위 비교: 시작 위치 [begin, end)
+inline void scan_scalar(const string& reference, const string& pattern, int max_err,
+                        size_t begin, size_t end, vector<long long>& out) {
+    size_t m = pattern.size();
+    for (size_t i = begin; i < end; i++) {
+        int err = 0;
+        for (size_t j = 0; j < m && err <= max_err; j++) {
+            if (reference[i + j] != pattern[j]) {
+                err++;
+            }
+        }
+        if (err <= max_err) {
+            out.push_back(static_cast<long long>(i));
+        }
+    }
+}
+
+// 64bit 워드 비교: 32염기씩 XOR 후 다른 칸 수를 popcount, 허용 수 초과시 중단
+inline void scan_word_body(const Packed& ref, const Packed& pat, int max_err,
+                           size_t begin, size_t end, vector<long long>& out) {
+    const uint64_t* rw = ref.words.data();
+    size_t n_words = pat.masks.size();
+    unsigned limit = static_cast<unsigned>(max_err);
+    for (size_t i = begin; i < end; i++) {
+        unsigned err = 0;
+        for (size_t j = 0; j < n_words && err <= limit; j++) {
+            uint64_t x = window(rw, i + 32 * j) ^ pat.words[j];
+            err += popcount64((x | (x >> 1)) & pat.masks[j]);
+        }
+        if (err <= limit) {
+            out.push_back(static_cast<long long>(i));
+        }
+    }
+}
+
+#ifdef SCANNER_AVX2
+// popcnt 명령을 쓰도록 컴파일한 워드 비교
+__attribute__((target("popcnt")))
+inline void scan_word_popcnt(const Packed& ref, const Packed& pat, int max_err,
+                             size_t begin, size_t end, vector<long long>& out) {
+    scan_word_body(ref, pat, max_err, begin, end, out);
+}
+#endif
+
+// 워드 비교: CPU가 popcnt를 지원하면 popcnt 명령 버전 사용
+inline void scan_word(const Packed& ref, const Packed& pat, int max_err,
+                      size_t begin, size_t end, vector<long long>& out) {
+#ifdef SCANNER_AVX2
+    static const bool hw_popcnt = __builtin_cpu_supports("popcnt");
+    if (hw_popcnt) {
+        scan_word_popcnt(ref, pat, max_err, begin, end, out);
+        return;
+    }
+#endif
+    scan_word_body(ref, pat, max_err, begin, end, out);
+}
+
+#ifdef SCANNER_AVX2
+// 4개 64bit 칸 각각의 popcount (니블 표 + SAD)
+__attribute__((target("avx2")))
+inline __m256i popcount_lanes(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low4));
+    __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi64(v, 4), low4));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+// AVX2: 연속한 시작 위치 4개를 한 번에 비교
+// 4의 배수 위치 p에서 p..p+3의 창은 같은 두 워드를 칸마다 다른 양(0, 2, 4, 6bit 더)만큼 밀어서 얻음
+__attribute__((target("avx2")))
+inline void scan_avx2(const Packed& ref, const Packed& pat, int max_err,
+                      size_t begin, size_t end, vector<long long>& out) {
+    const uint64_t* rw = ref.words.data();
+    size_t n_words = pat.masks.size();
+    const __m256i limit = _mm256_set1_epi64x(max_err);
+    const __m256i lane_shift = _mm256_setr_epi64x(0, 2, 4, 6);
+    const __m256i sixty_four = _mm256_set1_epi64x(64);
+
+    size_t i = begin;
+    for (; i < end && i % 4; i++) {
+        scan_word(ref, pat, max_err, i, i + 1, out);
+    }
+    for (; i + 4 <= end; i += 4) {
+        __m256i shift = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(2 * (i % 32))), lane_shift);
+        __m256i back = _mm256_sub_epi64(sixty_four, shift); // 0bit 이동 칸은 64가 되어 0
+        __m256i err = _mm256_setzero_si256();
+        for (size_t j = 0; j < n_words; j++) {
+            size_t k = i / 32 + j;
+            __m256i lo = _mm256_srlv_epi64(_mm256_set1_epi64x(static_cast<long long>(rw[k])), shift);
+            __m256i hi = _mm256_sllv_epi64(_mm256_set1_epi64x(static_cast<long long>(rw[k + 1])), back);
+            __m256i x  = _mm256_xor_si256(_mm256_or_si256(lo, hi),
+                                          _mm256_set1_epi64x(static_cast<long long>(pat.words[j])));
+            __m256i diff = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi64(x, 1)),
+                                            _mm256_set1_epi64x(static_cast<long long>(pat.masks[j])));
+            err = _mm256_add_epi64(err, popcount_lanes(diff));
+            // 네 위치 모두 허용 수를 넘으면 중단
+            if (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(err, limit))) == 0xF) {
+                break;
+            }
+        }
+        int over = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(err, limit)));
+        for (int l = 0; l < 4; l++) {
+            if (!(over & (1 << l))) {
+                out.push_back(static_cast<long long>(i + l));
+            }
+        }
+    }
+    scan_word(ref, pat, max_err, i, end, out);
+}
+
+// AVX-512: 연속한 시작 위치 8개를 한 번에 비교 (8의 배수 위치에서 칸마다 0~14bit 더 밀기)
+// GCC 12 이하는 AVX-512 내장 함수의 undefined 값에 대해 잘못된 경고를 내므로 끔
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f,avx512vpopcntdq")))
+inline void scan_avx512(const Packed& ref, const Packed& pat, int max_err,
+                        size_t begin, size_t end, vector<long long>& out) {
+    const uint64_t* rw = ref.words.data();
+    size_t n_words = pat.masks.size();
+    const __m512i limit = _mm512_set1_epi64(max_err);
+    const __m512i lane_shift = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m512i sixty_four = _mm512_set1_epi64(64);
+
+    size_t i = begin;
+    for (; i < end && i % 8; i++) {
+        scan_word(ref, pat, max_err, i, i + 1, out);
+    }
+    for (; i + 8 <= end; i += 8) {
+        __m512i shift = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(2 * (i % 32))), lane_shift);
+        __m512i back = _mm512_sub_epi64(sixty_four, shift);
+        __m512i err = _mm512_setzero_si512();
+        __mmask8 over = 0;
+        for (size_t j = 0; j < n_words; j++) {
+            size_t k = i / 32 + j;
+            __m512i lo = _mm512_srlv_epi64(_mm512_set1_epi64(static_cast<long long>(rw[k])), shift);
+            __m512i hi = _mm512_sllv_epi64(_mm512_set1_epi64(static_cast<long long>(rw[k + 1])), back);
+            __m512i x  = _mm512_xor_si512(_mm512_or_si512(lo, hi),
+                                          _mm512_set1_epi64(static_cast<long long>(pat.words[j])));
+            __m512i diff = _mm512_and_si512(_mm512_or_si512(x, _mm512_srli_epi64(x, 1)),
+                                            _mm512_set1_epi64(static_cast<long long>(pat.masks[j])));
+            err = _mm512_add_epi64(err, _mm512_popcnt_epi64(diff));
+            over = _mm512_cmpgt_epi64_mask(err, limit);
+            if (over == 0xFF) {
+                break;
+            }
+        }
+        for (int l = 0; l < 8; l++) {
+            if (!(over & (1 << l))) {
+                out.push_back(static_cast<long long>(i + l));
+            }
+        }
+    }
+    scan_word(ref, pat, max_err, i, end, out);
+}
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// 실행 중인 CPU에서 스캐너 사용 가능 여부
+inline bool supports(Kind k) {
+    switch (k) {
+        case Kind::Scalar:
+        case Kind::Word:
+            return true;
+#ifdef SCANNER_AVX2
+        case Kind::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Kind::Avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+#endif
+        default:
+            return false;
+    }
+}
+
+// 실행 중인 CPU가 지원하는 가장 빠른 스캐너
+inline Kind best_kind() {
+    for (Kind k : {Kind::Avx512, Kind::Avx2}) {
+        if (supports(k)) {
+            return k;
+        }
+    }
+    return Kind::Word;
+}
+
+// 모든 리드를 레퍼런스 전체에서 검색: 결과는 리드마다 scan_scalar 전체 검색과 같은 오름차순 위치
+// 레퍼런스 시작 위치를 BLOCK_POS 단위로 나누어 스레드에 분배하고, 블록 순서대로 합침
+// ACGT 외 문자가 있으면 kind는 Scalar로 바뀜
+inline vector<vector<long long>> locate_all(const string& reference, const vector<string>& reads,
+                                            int max_err, Kind& kind, size_t threads) {
+    Packed ref;
+    vector<Packed> pats(reads.size());
+    bool packable = ref.pack(reference);
+    for (size_t r = 0; r < reads.size() && packable; r++) {
+        packable = pats[r].pack(reads[r]);
+    }
+    if (!packable) {
+        kind = Kind::Scalar; // ACGT 외 문자는 문자 단위 비교로 처리
+    }
+#ifndef SCANNER_AVX2
+    if (kind == Kind::Avx2 || kind == Kind::Avx512) {
+        throw runtime_error("SIMD scanners are not available in this build");
+    }
+#endif
+
+    size_t n = reference.size();
+    size_t blocks = n / BLOCK_POS + 1;
+    vector<vector<pair<size_t, long long>>> found(blocks); // 블록별 (리드 번호, 위치)
+    par::parallel_for(blocks, threads, 1, [&](size_t b, size_t) {
+        vector<long long> hits;
+        size_t lo = b * BLOCK_POS;
+        for (size_t r = 0; r < reads.size(); r++) {
+            size_t m = reads[r].size();
+            if (m == 0 || n < m) {
+                continue;
+            }
+            size_t hi = min(lo + BLOCK_POS, n - m + 1);
+            if (lo >= hi) {
+                continue;
+            }
+            hits.clear();
+            switch (kind) {
+                case Kind::Scalar: scan_scalar(reference, reads[r], max_err, lo, hi, hits); break;
+                case Kind::Word:   scan_word(ref, pats[r], max_err, lo, hi, hits); break;
+#ifdef SCANNER_AVX2
+                case Kind::Avx2:   scan_avx2(ref, pats[r], max_err, lo, hi, hits); break;
+                case Kind::Avx512: scan_avx512(ref, pats[r], max_err, lo, hi, hits); break;
+#else
+                case Kind::Avx2:
+                case Kind::Avx512: break;
+#endif
+            }
+            for (long long p : hits) {
+                found[b].emplace_back(r, p);
+            }
+        }
+    });
+
+    vector<vector<long long>> positions(reads.size());
+    for (const auto& blk : found) {
+        for (const auto& h : blk) {
+            positions[h.first].push_back(h.second);
+        }
+    }
+    return positions;
+}
+
+} // namespace scan
+
+#endif // SCANNER_HPP
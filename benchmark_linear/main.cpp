@@ -5,38 +5,15 @@
 #include <stdexcept>
 #include <fstream>
 #include "IOUtils.hpp"
+#include "Scanner.hpp"
 
 using namespace std;
 using namespace std::chrono;
 
-vector<long long> brute_force_locate(const string& reference, const string& pattern, int max_err) {
-    vector<long long> pos;
-    long long n = reference.size();
-    long long m = pattern.size();
-    if (m == 0 || n < m) {
-        return pos;
-    }
-    for (long long i = 0; i + m <= n; i++) {
-        int err = 0;
-        for (long long j = 0; j < m && err <= max_err; j++) {
-            if (reference[i + j] != pattern[j]) {
-                err++;
-            }
-        }
-        if (err <= max_err) {
-            pos.push_back(i);
-        }
-    }
-    return pos;
-}
-
-string assemble_reads(const string& reference, const vector<string>& reads, int max_err) {
+string assemble_reads(const string& reference, const vector<string>& reads, int max_err,
+                      scan::Kind& kind, size_t threads) {
     auto t_map_s = high_resolution_clock::now();
-    vector<vector<long long>> positions;
-    positions.reserve(reads.size());
-    for (const string& read : reads) {
-        positions.push_back(brute_force_locate(reference, read, max_err));
-    }
+    vector<vector<long long>> positions = scan::locate_all(reference, reads, max_err, kind, threads);
     auto t_map_e = high_resolution_clock::now();
     long long map_ms = duration_cast<milliseconds>(t_map_e - t_map_s).count();
 
@@ -64,15 +41,56 @@ string assemble_reads(const string& reference, const vector<string>& reads, int
         tfs << "Read mapping time       : " << map_ms << " ms\n";
         tfs << "Assembly time           : " << asm_ms << " ms\n";
         tfs << "Total pipeline time     : " << total_ms << " ms\n";
+        tfs << "Scanner                 : " << scan::kind_name(kind) << "\n";
+        tfs << "Scan threads            : " << threads << "\n";
     }
     return assembled;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     const string ref_path  = "reference.txt";
     const string read_path = "reads.txt";
     const string out_path  = "linear_assembled.txt";
 
+    // 명령행 옵션: --scan scalar|word|avx2|avx512|auto (기본 auto = CPU 지원에 따라 선택), --threads N
+    scan::Kind kind = scan::best_kind();
+    size_t threads = par::default_threads();
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc || (arg != "--scan" && arg != "--threads")) {
+            cerr << "Error: unknown option or missing value: " << arg << '\n';
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--threads") {
+            try {
+                threads = stoul(value);
+            } catch (const exception&) {
+                threads = 0;
+            }
+            if (threads == 0) {
+                cerr << "Error: --threads must be positive\n";
+                return 1;
+            }
+        } else if (value != "auto") {
+            bool found = false;
+            for (scan::Kind k : {scan::Kind::Scalar, scan::Kind::Word, scan::Kind::Avx2, scan::Kind::Avx512}) {
+                if (value == scan::kind_name(k)) {
+                    kind = k;
+                    found = true;
+                }
+            }
+            if (!found) {
+                cerr << "Error: invalid value for --scan: " << value << '\n';
+                return 1;
+            }
+            if (!scan::supports(kind)) {
+                cerr << "Error: this CPU does not support " << value << '\n';
+                return 1;
+            }
+        }
+    }
+
     int max_err = 0;
     cout << "Enter max mismatch (D): ";
     if (!(cin >> max_err) || max_err < 0) {
@@ -83,7 +101,7 @@ int main() {
     try {
         const string reference     = io::read_reference(ref_path);
         const vector<string> reads = io::read_reads(read_path);
-        string assembled           = assemble_reads(reference, reads, max_err);
+        string assembled           = assemble_reads(reference, reads, max_err, kind, threads);
         io::write_text(out_path, assembled);
         cout << "Assembly finished. Output: " << out_path << '\n';
     } catch (const exception& e) {
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include "../CFM_index/SuffixArray.hpp"
+#include "../2FM_index/CodeUtil.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+// 비교 정렬 방식은 이 길이까지만 측정
+constexpr long long SORT_LIMIT = 10000000LL;
+
+// 랜덤 니블 코드 텍스트 생성 (끝에 센티넬)
+vector<uint8_t> random_codes(long long n, mt19937& gen) {
+    static const uint8_t codes[4] = {0x1, 0x5, 0x9, 0xD}; // A, C, G, T
+    uniform_int_distribution<int> dis(0, 3);
+    vector<uint8_t> text(n + 1);
+    for (long long i = 0; i < n; i++) {
+        text[i] = codes[dis(gen)];
+    }
+    text[n] = 0x0; // '$'
+    return text;
+}
+
+// 랜덤 DNA를 2fmindex 쌍 코드 텍스트로 (두 염기를 한 바이트로, 알파벳 256, 끝에 센티넬)
+vector<uint8_t> random_pairs(long long n, mt19937& gen) {
+    static const char bases[4] = {'A', 'C', 'G', 'T'};
+    uniform_int_distribution<int> dis(0, 3);
+    string dna(n, 'A');
+    for (auto& c : dna) {
+        c = bases[dis(gen)];
+    }
+    return code::pack_pairs(dna);
+}
+
+// 바이트 알파벳을 모두 쓰는 텍스트 (1~255 균등, 끝에 센티넬 0): 쌍 코드 SA-IS의 알파벳 256 전체 부하
+vector<uint8_t> random_bytes(long long n, mt19937& gen) {
+    uniform_int_distribution<int> dis(1, 255);
+    vector<uint8_t> text(n / 2 + 1);
+    for (size_t i = 0; i + 1 < text.size(); i++) {
+        text[i] = static_cast<uint8_t>(dis(gen));
+    }
+    text.back() = 0;
+    return text;
+}
+
+// 측정할 DNA 길이: 1000부터 10배씩, 입력한 최대 길이가 그 사이에 있으면 최대 길이도
+vector<long long> bench_lengths(long long max_len) {
+    vector<long long> lens;
+    for (long long n = 1000; n <= max_len; n *= 10) {
+        lens.push_back(n);
+    }
+    if (lens.empty() || lens.back() != max_len) {
+        lens.push_back(max_len);
+    }
+    return lens;
+}
+
+// 텍스트 하나의 SA-IS 시간 기록, 작은 N에서는 기존 방식과 결과 비교 (다르면 false)
+bool measure(ofstream& tfs, long long n, const char* name, const vector<uint8_t>& text, size_t alphabet) {
+    auto t_s = high_resolution_clock::now();
+    auto sa = suffix::sais(text, alphabet);
+    auto t_e = high_resolution_clock::now();
+    long long sais_ms = duration_cast<milliseconds>(t_e - t_s).count();
+
+    string sort_ms = "-";
+    if (n <= SORT_LIMIT) {
+        t_s = high_resolution_clock::now();
+        auto ref_sa = suffix::sort_suffixes(text);
+        t_e = high_resolution_clock::now();
+        sort_ms = to_string(duration_cast<milliseconds>(t_e - t_s).count());
+        if (ref_sa != sa) {
+            cerr << "SA mismatch at N = " << n << " (" << name << ")\n";
+            return false;
+        }
+    }
+
+    tfs << n << ',' << name << ',' << text.size() << ',' << sais_ms << ',' << sort_ms << '\n';
+    return true;
+}
+
+int main() {
+    const string out_path = "sa_timing.txt";
+
+    long long max_len = 0;
+    cout << "Enter max DNA length: ";
+    if (!(cin >> max_len) || max_len <= 0) {
+        cerr << "Invalid length.\n";
+        return 1;
+    }
+
+    ofstream tfs(out_path);
+    if (!tfs) {
+        cerr << "File open error: " << out_path << '\n';
+        return 1;
+    }
+    tfs << "N,alphabet,text_len,sais_ms,sort_ms\n";
+
+    // cfmindex 니블 코드 (알파벳 16), 2fmindex 쌍 코드 (알파벳 256, DNA라 실제 값은 16개),
+    // 같은 길이에서 256 값을 모두 쓰는 바이트 텍스트, N은 DNA 길이 (쌍 텍스트는 N / 2)
+    mt19937 gen(12345);
+    for (long long n : bench_lengths(max_len)) {
+        if (!measure(tfs, n, "nibble16", random_codes(n, gen), 16)
+            || !measure(tfs, n, "pair256", random_pairs(n, gen), 256)
+            || !measure(tfs, n, "byte256", random_bytes(n, gen), 256)) {
+            return 1;
+        }
+        cout << "N = " << n << " done.\n";
+    }
+
+    cout << "Benchmark finished. Output: " << out_path << '\n';
+    return 0;
+}
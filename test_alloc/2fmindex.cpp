@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "AllocCount.hpp"
+#include "../2FM_index/FMIndex.hpp"
+#include "../2FM_index/Assemble.hpp"
+
+using namespace std;
+
+// 2fmindex 검색이 작업 공간(SearchContext)을 데운 뒤 할당하지 않는지 확인 (홀수 길이, N 포함 리드)
+// 스트리밍 파이프라인도 데운 뒤의 배치에서 할당하지 않는지 확인
+int main() {
+    constexpr int MAX_ERR = 2;
+
+    mt19937 gen(2024);
+    string reference = alloc_test::random_reference(1 << 18, gen);
+    vector<string> owned = alloc_test::sample_reads(reference, 2000, 20, 151, true, gen);
+    vector<string_view> reads(owned.begin(), owned.end());
+
+    FMIndex fm(reference, 4);
+
+    SearchContext ctx;
+    int fails = alloc_test::expect_no_alloc("locate", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, ctx);
+        }
+    });
+
+    // 파이프라인: 배치 하나 = 200 리드, 매퍼 스레드 하나
+    alloc_test::ReadFiles files(vector<string>(owned.begin(), owned.begin() + 200), "2fm");
+    consensus::VoteTable votes(reference.size());
+    fails += alloc_test::expect_flat("pipeline", files, [&](const string& path) {
+        io::MappedFile file = io::map_read_file(path);
+        PipelineTimes times;
+        run_pipeline(fm, file, MAX_ERR, 1, 200, votes, reference.size(), times);
+    });
+
+    cout << (fails ? "FAILED" : "Search allocation-free after warm-up.") << '\n';
+    return fails;
+}
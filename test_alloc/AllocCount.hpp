@@ -0,0 +1,163 @@
+#ifndef ALLOCCOUNT_HPP
+#define ALLOCCOUNT_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include <string>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+// 전역 operator new 대체: 호출 수를 셈 (프로그램마다 이 헤더를 한 번만 포함)
+// 작업 공간을 재사용하는 검색이 데운 뒤에는 할당을 전혀 하지 않는지 확인하기 위함
+// 작업자 스레드의 할당도 세도록 원자 변수
+static std::atomic<size_t> alloc_count{0};
+
+static void* counted_alloc(std::size_t n, std::size_t align) {
+    alloc_count++;
+    if (n == 0) {
+        n = 1;
+    }
+#ifdef _WIN32
+    void* p = _aligned_malloc(n, align);
+#else
+    void* p = (align <= alignof(std::max_align_t)) ? std::malloc(n)
+                                                   : std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+static void counted_free(void* p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t n) { return counted_alloc(n, alignof(std::max_align_t)); }
+void* operator new[](std::size_t n) { return counted_alloc(n, alignof(std::max_align_t)); }
+void* operator new(std::size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+
+namespace alloc_test {
+
+// 반복 구간이 섞인 랜덤 레퍼런스 (반복 구간은 다중 hit를 만듦)
+inline std::string random_reference(size_t n, std::mt19937& gen) {
+    static const char BASES[4] = {'A', 'C', 'G', 'T'};
+    std::uniform_int_distribution<int> base(0, 3);
+    std::string ref(n, 'A');
+    for (auto& c : ref) {
+        c = BASES[base(gen)];
+    }
+    std::uniform_int_distribution<size_t> at(0, n - 2000);
+    for (int r = 0; r < 20; r++) {
+        ref.replace(at(gen), 1000, ref, at(gen), 1000);
+    }
+    return ref;
+}
+
+// 레퍼런스에서 길이 min_len~max_len 리드를 뽑아 염기 0~2개를 바꿈, with_n이면 가끔 'N'
+inline std::vector<std::string> sample_reads(const std::string& ref, size_t count, size_t min_len,
+                                             size_t max_len, bool with_n, std::mt19937& gen) {
+    static const char BASES[4] = {'A', 'C', 'G', 'T'};
+    std::uniform_int_distribution<size_t> len(min_len, max_len);
+    std::uniform_int_distribution<int> base(0, 3), edits(0, 2), pick(0, 99);
+    std::vector<std::string> reads;
+    for (size_t i = 0; i < count; i++) {
+        size_t l = len(gen);
+        std::uniform_int_distribution<size_t> at(0, ref.size() - l);
+        std::string r = ref.substr(at(gen), l);
+        std::uniform_int_distribution<size_t> col(0, l - 1);
+        for (int e = edits(gen); e > 0; e--) {
+            r[col(gen)] = (with_n && pick(gen) < 10) ? 'N' : BASES[base(gen)];
+        }
+        reads.push_back(r);
+    }
+    return reads;
+}
+
+// f()를 한 번 돌려 작업 공간을 데운 뒤 다시 돌리며 할당 수를 셈, 0이 아니면 실패 (1 반환)
+template <typename F>
+int expect_no_alloc(const char* name, F&& f) {
+    f();
+    size_t before = alloc_count;
+    f();
+    size_t n = alloc_count - before;
+    std::cout << name << ": " << n << " allocations" << (n ? "  <-- FAIL" : "") << '\n';
+    return n ? 1 : 0;
+}
+
+// 파이프라인 입력: reads를 한 배치로 보고 SHORT_BATCHES번, LONG_BATCHES번 반복한 리드 파일 두 개
+// (첫 줄, ','로 구분) 모든 배치가 같으므로 데운 뒤의 배치는 앞 배치와 같은 용량만 씀
+constexpr size_t SHORT_BATCHES = 16; // 미리 채운 배치 수 (스레드 하나면 7)보다 많아야 모든 배치가 데워짐
+constexpr size_t LONG_BATCHES  = 64;
+
+class ReadFiles {
+public:
+    ReadFiles(const std::vector<std::string>& reads, const std::string& name) {
+        auto dir = std::filesystem::temp_directory_path();
+        short_path = (dir / ("alloc_" + name + "_short.txt")).string();
+        long_path = (dir / ("alloc_" + name + "_long.txt")).string();
+        write(short_path, reads, SHORT_BATCHES);
+        write(long_path, reads, LONG_BATCHES);
+    }
+
+    ~ReadFiles() {
+        std::error_code ec;
+        std::filesystem::remove(short_path, ec);
+        std::filesystem::remove(long_path, ec);
+    }
+
+    std::string short_path;
+    std::string long_path;
+
+private:
+    static void write(const std::string& path, const std::vector<std::string>& reads, size_t copies) {
+        std::ofstream out(path, std::ios::binary);
+        for (size_t c = 0; c < copies; c++) {
+            for (size_t i = 0; i < reads.size(); i++) {
+                if (c || i) {
+                    out << ',';
+                }
+                out << reads[i];
+            }
+        }
+        out << '\n';
+    }
+};
+
+// run(path)을 짧은 입력과 긴 입력으로 한 번씩 실행해 할당 수 비교, 다르면 실패 (1 반환)
+// 준비(스레드, 큐, 미리 채운 배치)와 데우기는 두 실행이 같으므로 같은 수이면 데운 뒤의 배치는 할당하지 않음
+template <typename F>
+int expect_flat(const char* name, const ReadFiles& files, F&& run) {
+    size_t before = alloc_count;
+    run(files.short_path);
+    size_t n_short = alloc_count - before;
+    before = alloc_count;
+    run(files.long_path);
+    size_t n_long = alloc_count - before;
+    bool bad = n_long != n_short;
+    std::cout << name << ": " << n_short << " allocations for " << SHORT_BATCHES << " batches, " << n_long
+              << " for " << LONG_BATCHES << (bad ? "  <-- FAIL" : "") << '\n';
+    return bad ? 1 : 0;
+}
+
+} // namespace alloc_test
+
+#endif // ALLOCCOUNT_HPP
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "AllocCount.hpp"
+#include "../CFM_index/FMIndex.hpp"
+#include "../CFM_index/ShardedIndex.hpp"
+#include "../CFM_index/Mapping.hpp"
+
+using namespace std;
+
+// cfmindex 검색 경로가 작업 공간(SearchContext)을 데운 뒤 할당하지 않는지 확인
+// 스트리밍 파이프라인도 배치를 재사용하여 데운 뒤의 배치에서 할당하지 않는지 확인 (N 포함 리드)
+int main() {
+    constexpr int MAX_ERR = 2;
+
+    mt19937 gen(2024);
+    string reference = alloc_test::random_reference(1 << 18, gen);
+    vector<string> owned = alloc_test::sample_reads(reference, 2000, 20, 150, true, gen);
+    vector<string_view> reads(owned.begin(), owned.end());
+
+    IndexConfig cfg;
+    cfg.sa_rate = 4;
+    cfg.bidirectional = true;
+    cfg.kmer_k = 8;
+    FMIndex fm(reference, cfg);
+    ShardedIndex shards(reference, cfg, 4, 256, 1);
+    ShardedIndex fanned(reference, cfg, 4, 256, 1);
+    fanned.set_query_threads(4); // 작업자 3개 + 호출 스레드
+
+    int fails = 0;
+    size_t sink_sum = 0;
+
+    SearchContext plain;
+    fails += alloc_test::expect_no_alloc("locate (backtrack, k-mer seeds)", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, plain);
+        }
+    });
+
+    SearchContext pruned;
+    pruned.prune = true;
+    fails += alloc_test::expect_no_alloc("locate (pruned)", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, pruned);
+        }
+    });
+
+    SearchContext scheme;
+    scheme.mode = SearchMode::Scheme;
+    fails += alloc_test::expect_no_alloc("locate (search scheme)", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, scheme);
+        }
+    });
+
+    SearchContext capped;
+    capped.max_hits = 2;
+    fails += alloc_test::expect_no_alloc("locate (max hits)", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, capped);
+        }
+    });
+
+    SearchContext counted;
+    fails += alloc_test::expect_no_alloc("count / locate_intervals", [&] {
+        for (auto r : reads) {
+            fm.count(r, MAX_ERR, counted);
+        }
+    });
+
+    SearchContext streamed;
+    fails += alloc_test::expect_no_alloc("locate (callback)", [&] {
+        for (auto r : reads) {
+            fm.locate(r, MAX_ERR, streamed, [&](size_t pos) { sink_sum += pos; });
+        }
+    });
+
+    // 샤드 인덱스: 샤드를 차례로 검색하는 경우와 상주 작업자로 동시에 검색하는 경우
+    SearchContext shard_ctx;
+    fails += alloc_test::expect_no_alloc("sharded locate", [&] {
+        for (auto r : reads) {
+            shards.locate(r, MAX_ERR, shard_ctx);
+        }
+    });
+
+    SearchContext fan_ctx;
+    fails += alloc_test::expect_no_alloc("sharded locate (parallel shards)", [&] {
+        for (auto r : reads) {
+            fanned.locate(r, MAX_ERR, fan_ctx);
+        }
+    });
+
+    // 동시 검색 결과는 차례로 검색한 결과와 같아야 함
+    for (auto r : reads) {
+        if (fanned.locate(r, MAX_ERR, fan_ctx) != shards.locate(r, MAX_ERR, shard_ctx)) {
+            cout << "parallel shard search differs from serial search  <-- FAIL\n";
+            fails++;
+            break;
+        }
+    }
+
+    // 파이프라인: 배치 하나 = 200 리드, 매퍼 스레드 하나 (배치가 어느 매퍼로 갈지 정해져 있도록)
+    alloc_test::ReadFiles files(vector<string>(owned.begin(), owned.begin() + 200), "cfm");
+    MapConfig base{};
+    base.max_err = MAX_ERR;
+    base.mode = SearchMode::Backtrack;
+    base.threads = 1;
+    base.batch = 200;
+    base.reference = reference;
+    base.max_hits = SIZE_MAX;
+    base.multi = opt::MULTI_ALL;
+    consensus::VoteTable votes(reference.size());
+    auto pipeline = [&](const char* name, const MapConfig& mc) {
+        fails += alloc_test::expect_flat(name, files, [&](const string& path) {
+            io::MappedFile file = io::map_read_file(path);
+            PipelineTimes times;
+            run_pipeline(fm, file, mc, votes, reference.size(), times);
+        });
+    };
+    pipeline("pipeline", base);
+    MapConfig weighted = base;
+    weighted.multi = opt::MULTI_WEIGHT;
+    pipeline("pipeline (--multi weight)", weighted);
+    MapConfig fused = base;
+    fused.fused = true;
+    pipeline("pipeline (--fused)", fused);
+    MapConfig best = base;
+    best.best = true;
+    best.second_best = true;
+    pipeline("pipeline (--best)", best);
+    MapConfig anchored = base;
+    anchored.anchor = true;
+    pipeline("pipeline (--anchor)", anchored);
+    MapConfig indels = base;
+    indels.indels = true;
+    pipeline("pipeline (--indels)", indels);
+
+    cout << (fails ? "FAILED" : "All search paths allocation-free after warm-up.")
+         << " (checksum " << sink_sum << ")\n";
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "AllocCount.hpp"
+#include "../KFM_index/FMIndex.hpp"
+#include "../KFM_index/Assemble.hpp"
+
+using namespace std;
+
+// K염기 심볼 인덱스 하나의 검색이 작업 공간을 데운 뒤 할당하지 않는지 확인
+// 스트리밍 파이프라인도 데운 뒤의 배치에서 할당하지 않는지 확인 (배치 하나 = 200 리드, 매퍼 스레드 하나)
+template <size_t K>
+int check(const string& reference, const vector<string_view>& reads, const alloc_test::ReadFiles& files,
+          int max_err) {
+    FMIndex<K> fm(reference, 4);
+    typename FMIndex<K>::Context ctx;
+    string name = "locate (K=" + to_string(K) + ")";
+    int fails = alloc_test::expect_no_alloc(name.c_str(), [&] {
+        for (auto r : reads) {
+            fm.locate(r, max_err, ctx);
+        }
+    });
+    consensus::VoteTable votes(reference.size());
+    name = "pipeline (K=" + to_string(K) + ")";
+    fails += alloc_test::expect_flat(name.c_str(), files, [&](const string& path) {
+        io::MappedFile file = io::map_read_file(path);
+        PipelineTimes times;
+        run_pipeline(fm, file, max_err, 1, 200, votes, reference.size(), times);
+    });
+    return fails;
+}
+
+// kfmindex 검색이 K = 1~4 모두에서 데운 뒤 할당하지 않는지 확인 (K로 나누어 떨어지지 않는 길이, N 포함 리드)
+int main() {
+    constexpr int MAX_ERR = 2;
+
+    mt19937 gen(2024);
+    string reference = alloc_test::random_reference(1 << 18, gen);
+    vector<string> owned = alloc_test::sample_reads(reference, 2000, 20, 151, true, gen);
+    vector<string_view> reads(owned.begin(), owned.end());
+
+    alloc_test::ReadFiles files(vector<string>(owned.begin(), owned.begin() + 200), "kfm");
+
+    int fails = check<1>(reference, reads, files, MAX_ERR) + check<2>(reference, reads, files, MAX_ERR)
+              + check<3>(reference, reads, files, MAX_ERR) + check<4>(reference, reads, files, MAX_ERR);
+
+    cout << (fails ? "FAILED" : "Search allocation-free after warm-up.") << '\n';
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <filesystem>
+#include "../CFM_index/FMIndex.hpp"
+#include "../CFM_index/ShardedIndex.hpp"
+#include "../CFM_index/IOUtils.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+constexpr uint64_t LIMIT_32     = uint64_t(1) << 32; // 32bit 위치 한계
+constexpr size_t   DEFAULT_LEN  = size_t(1) << 22;   // 인자가 없을 때 레퍼런스 길이
+constexpr size_t   DEFAULT_SPAN = size_t(1) << 20;   // 인자가 없을 때 샤드 몫 길이
+constexpr size_t   COMPARE_LEN  = size_t(1) << 24;   // 이 길이까지는 단일 인덱스도 만들어 샤드 결과와 비교
+constexpr size_t   OVERLAP      = 256;               // 샤드 겹침
+constexpr size_t   READ_LEN     = 40;                // 패턴 길이 (랜덤 레퍼런스에서 사실상 유일)
+constexpr int      MAX_ERR      = 2;
+constexpr size_t   RANDOM_READS = 2000;              // 경계 밖 랜덤 위치 패턴 수
+constexpr size_t   SA_RATE      = 64;                // 2^32 길이에서도 샤드 인덱스 전체가 메모리에 들어가도록
+constexpr size_t   KMER_K       = 8;                 // 작은 k-mer 표 (2^32 행을 넘는 단일 인덱스면 64bit 구간)
+
+// 재현 가능한 랜덤 염기열
+struct Bases {
+    uint64_t x = 88172645463325252ULL;
+
+    char next() {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return "ACGT"[(x >> 11) & 3];
+    }
+};
+
+// 레퍼런스를 파일로 써서 매핑: 2^32보다 길어도 샤드 구축 중 상주 메모리는 샤드 하나 분량
+string write_reference(size_t n) {
+    string path = (filesystem::temp_directory_path() / "test_index_reference.txt").string();
+    ofstream out(path, ios::binary);
+    Bases gen;
+    string chunk;
+    for (size_t done = 0; done < n;) {
+        chunk.resize(min<size_t>(n - done, size_t(1) << 24));
+        for (auto& c : chunk) {
+            c = gen.next();
+        }
+        out.write(chunk.data(), static_cast<streamsize>(chunk.size()));
+        done += chunk.size();
+    }
+    if (!out) {
+        throw runtime_error("write fail: " + path);
+    }
+    return path;
+}
+
+// 패턴을 심을 위치: 2^32 앞뒤, 샤드 경계 앞뒤 (2^32 근처 샤드 포함), 텍스트 끝, 랜덤
+vector<size_t> plant_positions(size_t n, const vector<array<size_t, 3>>& layout) {
+    vector<size_t> at;
+    auto add = [&](size_t p) {
+        if (p + READ_LEN <= n) {
+            at.push_back(p);
+        }
+    };
+    if (n > LIMIT_32) {
+        for (size_t d = 0; d <= READ_LEN + 8; d++) {
+            add(LIMIT_32 - READ_LEN - 4 + d); // 2^32 앞에서 끝나는 것부터 2^32 뒤에서 시작하는 것까지
+        }
+    }
+    for (const auto& s : layout) {
+        if (s[0] >= READ_LEN) {
+            for (size_t back : {READ_LEN, READ_LEN / 2, size_t(1)}) {
+                add(s[0] - back); // 앞 샤드 몫에서 시작해 겹침 구간으로 넘어가는 패턴
+            }
+        }
+        add(s[0]);
+    }
+    add(n - READ_LEN);
+    mt19937_64 gen(n);
+    uniform_int_distribution<size_t> pos(0, n - READ_LEN);
+    for (size_t i = 0; i < RANDOM_READS; i++) {
+        add(pos(gen));
+    }
+    return at;
+}
+
+// 위치 p의 패턴에 mismatch e개 (서로 다른 열의 염기를 바꿈)
+string make_pattern(string_view ref, size_t p, int e) {
+    string pat(ref.substr(p, READ_LEN));
+    for (int i = 0; i < e; i++) {
+        char& c = pat[(i * 17 + p) % READ_LEN];
+        c = (c == 'A') ? 'C' : 'A';
+    }
+    return pat;
+}
+
+size_t mismatches(string_view ref, size_t at, string_view pat) {
+    size_t d = 0;
+    for (size_t i = 0; i < pat.size(); i++) {
+        d += ref[at + i] != pat[i];
+    }
+    return d;
+}
+
+// 단일 인덱스나 샤드 인덱스로 count / locate를 끝까지 확인:
+// 심은 위치가 결과에 있고, 결과가 정렬되어 중복이 없고, 모든 위치가 레퍼런스와 MAX_ERR 이하로 다르고,
+// count가 locate 결과 수와 같아야 함 (2^32 이상 위치를 돌려준 패턴 수를 over에 더함)
+template <typename Index>
+size_t check(const Index& fm, string_view ref, const vector<size_t>& at, const char* name, size_t& over,
+             vector<vector<size_t>>* results) {
+    SearchContext ctx, cnt;
+    size_t bad = 0;
+    auto fail = [&](const string& what, size_t p) {
+        if (bad++ < 10) {
+            cerr << name << ": " << what << " for pattern at " << p << '\n';
+        }
+    };
+    for (size_t i = 0; i < at.size(); i++) {
+        size_t p = at[i];
+        string pat = make_pattern(ref, p, static_cast<int>(i % (MAX_ERR + 1)));
+        const vector<size_t>& hits = fm.locate(pat, MAX_ERR, ctx);
+        if (!binary_search(hits.begin(), hits.end(), p)) {
+            fail("planted position missing", p);
+        }
+        for (size_t h = 0; h < hits.size(); h++) {
+            if ((h && hits[h] <= hits[h - 1]) || hits[h] + READ_LEN > ref.size()
+                || mismatches(ref, hits[h], pat) > MAX_ERR) {
+                fail("bad hit " + to_string(hits[h]), p);
+                break;
+            }
+        }
+        if (fm.count(pat, MAX_ERR, cnt) != hits.size()) {
+            fail("count " + to_string(cnt.rows) + " != locate " + to_string(hits.size()), p);
+        }
+        over += !hits.empty() && hits.back() >= LIMIT_32;
+        if (results) {
+            results->push_back(hits);
+        }
+    }
+    cout << name << ": checked " << at.size() << " patterns, " << bad << " mismatches\n";
+    return bad;
+}
+
+// 매핑한 레퍼런스로 단일 / 샤드 인덱스를 만들어 확인 (파일은 호출한 쪽에서 지움)
+bool run(const string& path, size_t n, size_t span) {
+    io::MappedFile file(path);
+    string_view ref(file.data(), file.size());
+    size_t count = span ? (n + span - 1) / span : 1;
+    vector<size_t> at = plant_positions(n, ShardedIndex::layout(n, count, OVERLAP));
+
+    IndexConfig cfg;
+    cfg.sa_rate = SA_RATE;
+    cfg.kmer_k = KMER_K;
+    size_t bad = 0, over = 0;
+    vector<vector<size_t>> single_hits, shard_hits;
+
+    // 단일 인덱스: 샤드 없이 (2^32보다 길면 2^32 행을 넘는 OCC, SA, k-mer 표), 짧으면 샤드와 비교용
+    if (!span || n <= COMPARE_LEN) {
+        auto t_s = high_resolution_clock::now();
+        FMIndex fm(string(ref), cfg);
+        cout << "Single index: " << duration_cast<milliseconds>(high_resolution_clock::now() - t_s).count()
+             << " ms, " << fm.memory_bytes() << " bytes\n";
+        bad += check(fm, ref, at, "single index", over, &single_hits);
+    }
+
+    // 샤드 인덱스: 몫이 span인 샤드, 전역 위치는 샤드 시작 + 샤드 안 위치 (64bit)
+    if (span) {
+        auto t_s = high_resolution_clock::now();
+        ShardedIndex fm(ref, cfg, count, OVERLAP, 1);
+        cout << "Sharded index: " << count << " shards, "
+             << duration_cast<milliseconds>(high_resolution_clock::now() - t_s).count() << " ms, "
+             << fm.memory_bytes() << " bytes\n";
+        bad += check(fm, ref, at, "sharded index", over, &shard_hits);
+        if (!single_hits.empty() && single_hits != shard_hits) {
+            cerr << "sharded results differ from the single index\n";
+            bad++;
+        }
+    }
+
+    cout << over << " patterns with hits at or past 2^32, peak RSS " << io::peak_rss_bytes() << " bytes\n";
+    return !bad && (n <= LIMIT_32 || over > 0);
+}
+
+// cfmindex의 FMIndex / ShardedIndex count, locate를 2^32 경계에서 끝까지 확인
+// 사용: test_index [길이 (기본 2^22)] [샤드 몫 길이 (기본 2^20, 0이면 단일 인덱스만)]
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? strtoull(argv[1], nullptr, 10) : DEFAULT_LEN;
+    size_t span = (argc > 2) ? strtoull(argv[2], nullptr, 10) : DEFAULT_SPAN;
+    if (n <= READ_LEN || (span && span < OVERLAP)) {
+        cerr << "Usage: test_index [length > " << READ_LEN << "] [shard length >= " << OVERLAP
+             << " or 0]\n";
+        return 1;
+    }
+
+    string path = write_reference(n);
+    bool ok = run(path, n, span);
+    filesystem::remove(path);
+    if (!ok) {
+        cout << "FAILED\n";
+        return 1;
+    }
+    cout << "Index check passed.\n";
+    return 0;
+}
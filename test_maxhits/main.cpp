@@ -0,0 +1,102 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "../CFM_index/FMIndex.hpp"
+
+using namespace std;
+
+// 반복 구간이 많은 랜덤 레퍼런스: 구간 하나를 여러 곳에 복사하고 가끔 염기를 바꿈
+string repeat_reference(size_t n, mt19937& gen) {
+    static const char BASES[4] = {'A', 'C', 'G', 'T'};
+    uniform_int_distribution<int> base(0, 3), pick(0, 99);
+    string ref(n, 'A');
+    for (auto& c : ref) {
+        c = BASES[base(gen)];
+    }
+    uniform_int_distribution<size_t> at(0, n - 600);
+    for (int seg = 0; seg < 8; seg++) {
+        size_t from = at(gen);
+        for (int copy = 0; copy < 25; copy++) {
+            size_t to = at(gen);
+            for (size_t i = 0; i < 500; i++) {
+                ref[to + i] = (pick(gen) < 2) ? BASES[base(gen)] : ref[from + i];
+            }
+        }
+    }
+    return ref;
+}
+
+// 레퍼런스에서 길이 30~90 리드를 뽑아 염기 0~3개를 바꿈 (가끔 'N')
+vector<string> sample_reads(const string& ref, size_t count, mt19937& gen) {
+    static const char BASES[5] = {'A', 'C', 'G', 'T', 'N'};
+    uniform_int_distribution<size_t> len(30, 90);
+    uniform_int_distribution<int> base(0, 4), edits(0, 3);
+    vector<string> reads;
+    for (size_t i = 0; i < count; i++) {
+        size_t l = len(gen);
+        uniform_int_distribution<size_t> at(0, ref.size() - l), col(0, l - 1);
+        string r = ref.substr(at(gen), l);
+        for (int e = edits(gen); e > 0; e--) {
+            r[col(gen)] = BASES[base(gen)];
+        }
+        reads.push_back(r);
+    }
+    return reads;
+}
+
+// --max-hits 상한이 검색 방식과 무관한지 확인: 백트래킹과 검색 스킴의 capped / 위치 / 위치 수가 같고,
+// 상한 초과는 상한 없는 검색의 서로 다른 위치 수가 상한보다 클 때만
+int main() {
+    mt19937 gen(7);
+    string reference = repeat_reference(200000, gen);
+    vector<string> reads = sample_reads(reference, 1500, gen);
+
+    IndexConfig cfg;
+    cfg.bidirectional = true;
+    cfg.kmer_k = 8;
+    FMIndex fm(reference, cfg);
+
+    size_t checked = 0, capped_cnt = 0, bad = 0;
+    auto fail = [&](const string& what, size_t r, int d, size_t cap) {
+        if (bad++ < 10) {
+            cerr << what << ": read " << r << ", D=" << d << ", max hits " << cap << '\n';
+        }
+    };
+
+    SearchContext full, back, scheme, back_iv, scheme_iv;
+    scheme.mode = scheme_iv.mode = SearchMode::Scheme;
+    back_iv.intervals_only = scheme_iv.intervals_only = true;
+    for (int d = 1; d <= 3; d++) {
+        for (size_t cap : {size_t(1), size_t(5), size_t(40)}) {
+            back.max_hits = scheme.max_hits = back_iv.max_hits = scheme_iv.max_hits = cap;
+            for (size_t r = 0; r < reads.size(); r++) {
+                string_view read = reads[r];
+                size_t distinct = fm.locate(read, d, full).size();
+                fm.locate(read, d, back);
+                fm.locate(read, d, scheme);
+                fm.count(read, d, back_iv);
+                fm.count(read, d, scheme_iv);
+                bool expect = distinct > cap;
+                if (back.capped != expect || scheme.capped != expect
+                    || back_iv.capped != expect || scheme_iv.capped != expect) {
+                    fail("capped differs", r, d, cap);
+                } else if (!expect && (back.hits != full.hits || scheme.hits != full.hits
+                                       || back_iv.rows != distinct || scheme_iv.rows != distinct)) {
+                    fail("hits differ", r, d, cap);
+                }
+                checked++;
+                capped_cnt += expect;
+            }
+        }
+    }
+
+    cout << "Checked " << checked << " searches (" << capped_cnt << " over the cap), " << bad
+         << " mismatches\n";
+    if (bad) {
+        return 1;
+    }
+    cout << "Hit cap agrees between backtracking and search scheme.\n";
+    return 0;
+}
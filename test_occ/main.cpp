@@ -0,0 +1,142 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "../CFM_index/OccTable.hpp"
+#include "../CFM_index/KmerTable.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+constexpr uint64_t LIMIT_32    = uint64_t(1) << 32; // 32bit 누적 수 한계
+constexpr size_t   DEFAULT_LEN = size_t(1) << 24;   // 인자가 없을 때 길이
+constexpr size_t   FULL_LIMIT  = 10000000;          // 이 길이까지는 모든 위치 검사
+constexpr size_t   SAMPLE      = 10000019;          // 그보다 길면 이 간격 + 경계 주변만 검사
+constexpr size_t   NEAR        = 300;               // 경계 앞뒤 검사 폭
+constexpr size_t   VARY        = 1000003;           // 이 간격마다 랜덤 염기, 나머지는 A
+constexpr size_t   KMER_K      = 4;                 // 검사할 k-mer 표 길이
+
+// 재현 가능한 텍스트: 대부분 A라서 길이가 2^32를 넘으면 A 누적 수도 2^32를 넘음
+// 센티넬은 2^32 바로 앞 (짧으면 가운데)
+struct Text {
+    size_t n, sent;
+    uint64_t x = 88172645463325252ULL;
+
+    uint8_t next(size_t i) {
+        static const uint8_t CODES[4] = {0x1, 0x5, 0x9, 0xD}; // A, C, G, T
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (i == sent) {
+            return code::SENT_CODE;
+        }
+        return (i % VARY == 0) ? CODES[(x >> 11) & 3] : CODES[0];
+    }
+};
+
+// 경계 근처인지: 2^32 행, 상위 블록 시작, 텍스트 끝
+bool near_boundary(size_t i, size_t n) {
+    const size_t super = occ::SUPER_BLOCKS * occ::BLOCK_BASES;
+    size_t off = i % super;
+    return (i + NEAR > LIMIT_32 && i < LIMIT_32 + NEAR) || off < NEAR || off + NEAR > super || i + NEAR > n;
+}
+
+// 사용: test_occ [BWT 길이 (기본 2^24, 2^32 = 4294967296보다 길면 32bit 경계를 넘음)]
+int main(int argc, char* argv[]) {
+    const size_t n = (argc > 1) ? strtoull(argv[1], nullptr, 10) : DEFAULT_LEN;
+    if (n <= 1) {
+        cerr << "Usage: test_occ [BWT length > 1]\n";
+        return 1;
+    }
+    const size_t sent = (n > LIMIT_32) ? LIMIT_32 - 7 : n / 2;
+
+    // 4bit 팩킹 BWT 생성
+    Text gen{n, sent};
+    vector<uint8_t> packed((n + 1) / 2, 0);
+    for (size_t i = 0; i < n; i++) {
+        uint8_t c = gen.next(i);
+        packed[i >> 1] |= (i & 1) ? c : static_cast<uint8_t>(c << 4);
+    }
+
+    auto t_s = high_resolution_clock::now();
+    occ::OccTable table;
+    table.build(packed, n);
+    auto t_e = high_resolution_clock::now();
+    vector<uint8_t>().swap(packed);
+    cout << "Build: " << duration_cast<milliseconds>(t_e - t_s).count() << " ms, "
+         << table.bytes() << " bytes\n";
+
+    // 같은 텍스트를 다시 만들며 누적 수와 rank / rank_all / symbol 비교
+    Text chk{n, sent};
+    uint64_t acc[5] = {0, 0, 0, 0, 0};
+    size_t checked = 0, bad = 0, over = 0;
+    for (size_t i = 0; i <= n; i++) {
+        bool probe = n <= FULL_LIMIT || i % SAMPLE == 0 || near_boundary(i, n)
+                  || (acc[1] + NEAR > LIMIT_32 && acc[1] < LIMIT_32 + NEAR);
+        if (probe) {
+            size_t out[5];
+            table.rank_all(i, out);
+            for (int k = 0; k < 5; k++) {
+                if (out[k] != acc[k] || table.rank(k, i) != acc[k]) {
+                    if (bad++ < 10) {
+                        cerr << "rank mismatch at " << i << " symbol " << k << ": " << out[k]
+                             << " / " << table.rank(k, i) << " expected " << acc[k] << '\n';
+                    }
+                }
+            }
+            checked++;
+            over += acc[1] >= LIMIT_32;
+        }
+        if (i == n) {
+            break;
+        }
+        int k = code::code_to_idx(chk.next(i));
+        if (probe && table.symbol(i) != k) {
+            bad++;
+        }
+        acc[k]++;
+    }
+
+    cout << "Checked " << checked << " positions (" << over << " with A count >= 2^32), "
+         << bad << " mismatches\n";
+    if (bad) {
+        return 1;
+    }
+    cout << "OCC table check passed.\n";
+
+    // 같은 OCC 표로 k-mer 표를 만들고, 키마다 rank로 따로 후방 탐색한 구간과 비교
+    array<uint64_t, 5> C;
+    uint64_t sum = 0;
+    for (int k = 0; k < 5; k++) {
+        C[k] = sum;
+        sum += acc[k];
+    }
+    kmer::KmerTable kmers;
+    kmers.build(KMER_K, table, C, n);
+    size_t kbad = 0, kover = 0;
+    for (size_t key = 0; key < (size_t(1) << (2 * KMER_K)); key++) {
+        uint64_t lo = 0, hi = n;
+        for (size_t d = 0; d < KMER_K && lo < hi; d++) {
+            int c = static_cast<int>((key >> (2 * d)) & 3) + 1;
+            lo = C[c] + table.rank(c, lo);
+            hi = C[c] + table.rank(c, hi);
+        }
+        kmer::Range r = kmers[key];
+        bool same = (lo < hi) ? (r.lo == lo && r.hi == hi) : (r.lo >= r.hi);
+        if (!same && kbad++ < 10) {
+            cerr << "k-mer mismatch at key " << key << ": [" << r.lo << ", " << r.hi
+                 << ") expected [" << lo << ", " << hi << ")\n";
+        }
+        kover += lo < hi && hi > LIMIT_32;
+    }
+    cout << "Checked " << (size_t(1) << (2 * KMER_K)) << " " << KMER_K << "-mers ("
+         << kover << " ending past 2^32, " << kmers.bytes() << " bytes), " << kbad << " mismatches\n";
+    if (kbad || (n > LIMIT_32 && kover == 0)) {
+        return 1;
+    }
+    cout << "k-mer table check passed.\n";
+    return 0;
+}